@@ -0,0 +1,181 @@
+// JSON for C++ : end-to-end benchmarks
+// Belongs to the public domain
+
+#include "corpus.hpp"
+#include "harness.hpp"
+#include "variant.hpp"
+
+#include <json-cpp.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Runs all parse and generate paths on `objects`, each object is one document
+    template<typename T>
+    void runCorpus(bench::Runner& runner, const std::string& name, const std::vector<T>& objects)
+    {
+        std::vector<std::string> docs;
+        std::size_t bytes = 0;
+        for (auto& object : objects)
+        {
+            docs.push_back(jsoncpp::to_string(object));
+            bytes += docs.back().size();
+        }
+
+        std::vector<bench::Variant> variants(docs.size());
+        for (std::size_t i = 0; i != docs.size(); ++i)
+            jsoncpp::parse(variants[i], docs[i]);
+
+        runner.run(name + "/parse/fields", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& doc : docs)
+            {
+                T object;
+                jsoncpp::parse(object, doc);
+                result += sizeof(object);
+            }
+            return result;
+        });
+
+        runner.run(name + "/parse/cstring", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& doc : docs)
+            {
+                T object;
+                jsoncpp::parse(object, doc.c_str());
+                result += sizeof(object);
+            }
+            return result;
+        });
+
+        runner.run(name + "/parse/istream", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& doc : docs)
+            {
+                std::istringstream stream{doc};
+                T object;
+                jsoncpp::parse(object, stream);
+                result += sizeof(object);
+            }
+            return result;
+        });
+
+        runner.run(name + "/parse/variant", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& doc : docs)
+            {
+                bench::Variant variant;
+                jsoncpp::parse(variant, doc);
+                result += static_cast<std::size_t>(variant.m_type);
+            }
+            return result;
+        });
+
+        runner.run(name + "/generate/fields", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& object : objects)
+                result += jsoncpp::to_string(object).size();
+            return result;
+        });
+
+        runner.run(name + "/generate/variant", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& variant : variants)
+                result += jsoncpp::to_string(variant).size();
+            return result;
+        });
+    }
+
+    // Reads a few fields of each status: the full parse builds all of them, the on-demand one skips the rest
+    void runTwitterFewFields(bench::Runner& runner, const bench::Twitter& twitter)
+    {
+        auto doc = jsoncpp::to_string(twitter);
+
+        runner.run("twitter/few-fields/parse", doc.size(), 1, [&]
+        {
+            bench::Twitter object;
+            jsoncpp::parse(object, doc);
+
+            std::size_t result = 0;
+            for (auto& status : object.statuses)
+                result += static_cast<std::size_t>(status.id) + status.user.screen_name.size();
+            return result;
+        });
+
+        runner.run("twitter/few-fields/on-demand", doc.size(), 1, [&]
+        {
+            auto document = jsoncpp::parse_on_demand(doc);
+
+            std::size_t result = 0;
+            for (auto& status : document["statuses"])
+            {
+                result += static_cast<std::size_t>(status["id"].getNumber());
+                result += status["user"]["screen_name"].getString().size();
+            }
+            return result;
+        });
+    }
+
+    // Reads one field of each log line
+    void runLogFewFields(bench::Runner& runner, const std::vector<bench::LogLine>& lines)
+    {
+        std::vector<std::string> docs;
+        std::size_t bytes = 0;
+        for (auto& line : lines)
+        {
+            docs.push_back(jsoncpp::to_string(line));
+            bytes += docs.back().size();
+        }
+
+        runner.run("log/few-fields/parse", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& doc : docs)
+            {
+                bench::LogLine line;
+                jsoncpp::parse(line, doc);
+                result += line.level.size();
+            }
+            return result;
+        });
+
+        runner.run("log/few-fields/on-demand", bytes, docs.size(), [&]
+        {
+            std::size_t result = 0;
+            for (auto& doc : docs)
+            {
+                auto document = jsoncpp::parse_on_demand(doc);
+                result += document["level"].getString().size();
+            }
+            return result;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    auto options = bench::parseOptions(argc, argv);
+    bench::Runner runner{options};
+    bench::Random rnd{42};
+
+    auto twitter = bench::makeTwitter(rnd, 2000);
+    runCorpus(runner, "twitter", std::vector<bench::Twitter>{twitter});
+    runCorpus(runner, "canada", std::vector<bench::Canada>{bench::makeCanada(rnd, 50, 1000)});
+    runCorpus(runner, "citm", std::vector<bench::Citm>{bench::makeCitm(rnd, 200, 2000)});
+    auto logLines = bench::makeLogLines(rnd, 10000);
+    runCorpus(runner, "log", logLines);
+
+    runTwitterFewFields(runner, twitter);
+    runLogFewFields(runner, logLines);
+
+    return bench::finish(runner, options);
+}
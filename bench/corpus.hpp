@@ -0,0 +1,327 @@
+// JSON for C++ : benchmark corpus
+// Belongs to the public domain
+
+#pragma once
+
+#include <json-cpp.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // Linear congruential generator, the corpus must be the same on every run and platform
+    class Random
+    {
+    public:
+        explicit Random(std::uint64_t seed) : m_state{seed} {}
+
+        std::uint32_t next()
+        {
+            m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<std::uint32_t>(m_state >> 33);
+        }
+
+        int uniform(int n) { return static_cast<int>(next() % static_cast<std::uint32_t>(n)); }
+        double real() { return next() / 2147483648.0; }
+
+        std::string word(int minLength, int maxLength)
+        {
+            std::string result;
+            for (auto n = minLength + uniform(maxLength - minLength + 1); n != 0; --n)
+                result.push_back(static_cast<char>('a' + uniform(26)));
+            return result;
+        }
+
+        std::string text(int words)
+        {
+            static const char* const extras[] = {" \"quoted\"", " caf\xC3\xA9", " \xF0\x9F\x98\x80", " tab\t", " back\\slash", " line\n"};
+
+            auto result = word(1, 10);
+            for (auto i = 1; i < words; ++i)
+            {
+                result += ' ';
+                result += uniform(8) == 0 ? extras[uniform(6)] : word(1, 10);
+            }
+            return result;
+        }
+
+    private:
+        std::uint64_t m_state;
+    };
+
+    // twitter.json-like: string-heavy
+    struct User
+    {
+        long long id;
+        std::string name;
+        std::string screen_name;
+        std::string description;
+        int followers_count;
+        bool verified;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, User& o)
+    {
+        fields(o, stream, "id", o.id, "name", o.name, "screen_name", o.screen_name,
+            "description", o.description, "followers_count", o.followers_count, "verified", o.verified);
+    }
+
+    struct Status
+    {
+        long long id;
+        std::string created_at;
+        std::string text;
+        User user;
+        std::vector<std::string> hashtags;
+        int retweet_count;
+        bool favorited;
+        std::string lang;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Status& o)
+    {
+        fields(o, stream, "id", o.id, "created_at", o.created_at, "text", o.text, "user", o.user,
+            "hashtags", o.hashtags, "retweet_count", o.retweet_count, "favorited", o.favorited, "lang", o.lang);
+    }
+
+    struct Twitter
+    {
+        std::vector<Status> statuses;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Twitter& o)
+    {
+        fields(o, stream, "statuses", o.statuses);
+    }
+
+    inline Twitter makeTwitter(Random& rnd, int count)
+    {
+        Twitter result;
+        for (auto i = 0; i != count; ++i)
+        {
+            Status s;
+            s.id = 505874924095815681ll + rnd.uniform(1000000);
+            s.created_at = "Sun Aug 31 00:29:15 +0000 2014";
+            s.text = rnd.text(5 + rnd.uniform(20));
+            s.user = User{rnd.uniform(1 << 30), rnd.word(3, 12), rnd.word(5, 15), rnd.text(rnd.uniform(30)), rnd.uniform(100000), rnd.uniform(10) == 0};
+            for (auto n = rnd.uniform(4); n != 0; --n)
+                s.hashtags.push_back(rnd.word(3, 10));
+            s.retweet_count = rnd.uniform(1000);
+            s.favorited = rnd.uniform(2) == 0;
+            s.lang = rnd.uniform(3) == 0 ? "ja" : "en";
+            result.statuses.push_back(s);
+        }
+        return result;
+    }
+
+    // canada.json-like: number-heavy
+    struct Geometry
+    {
+        std::string type;
+        std::vector<std::vector<std::vector<double>>> coordinates;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Geometry& o)
+    {
+        fields(o, stream, "type", o.type, "coordinates", o.coordinates);
+    }
+
+    struct Feature
+    {
+        std::string type;
+        std::map<std::string, std::string> properties;
+        Geometry geometry;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Feature& o)
+    {
+        fields(o, stream, "type", o.type, "properties", o.properties, "geometry", o.geometry);
+    }
+
+    struct Canada
+    {
+        std::string type;
+        std::vector<Feature> features;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Canada& o)
+    {
+        fields(o, stream, "type", o.type, "features", o.features);
+    }
+
+    inline Canada makeCanada(Random& rnd, int rings, int points)
+    {
+        Canada result{"FeatureCollection", {}};
+        Feature feature{"Feature", {{"name", "Canada"}}, {"Polygon", {}}};
+        for (auto i = 0; i != rings; ++i)
+        {
+            std::vector<std::vector<double>> ring;
+            for (auto j = 0; j != points; ++j)
+                ring.push_back({-141.0 + rnd.real() * 90.0, 41.0 + rnd.real() * 42.0});
+            feature.geometry.coordinates.push_back(ring);
+        }
+        result.features.push_back(feature);
+        return result;
+    }
+
+    // citm_catalog.json-like: nested objects and integer arrays
+    struct Event
+    {
+        long long id;
+        std::string name;
+        std::vector<int> subTopicIds;
+        std::vector<int> topicIds;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Event& o)
+    {
+        fields(o, stream, "id", o.id, "name", o.name, "subTopicIds", o.subTopicIds, "topicIds", o.topicIds);
+    }
+
+    struct Price
+    {
+        int amount;
+        long long audienceSubCategoryId;
+        long long seatCategoryId;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Price& o)
+    {
+        fields(o, stream, "amount", o.amount, "audienceSubCategoryId", o.audienceSubCategoryId, "seatCategoryId", o.seatCategoryId);
+    }
+
+    struct Area
+    {
+        long long areaId;
+        std::vector<int> blockIds;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Area& o)
+    {
+        fields(o, stream, "areaId", o.areaId, "blockIds", o.blockIds);
+    }
+
+    struct SeatCategory
+    {
+        std::vector<Area> areas;
+        long long seatCategoryId;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, SeatCategory& o)
+    {
+        fields(o, stream, "areas", o.areas, "seatCategoryId", o.seatCategoryId);
+    }
+
+    struct Performance
+    {
+        long long id;
+        long long eventId;
+        std::vector<Price> prices;
+        std::vector<SeatCategory> seatCategories;
+        long long start;
+        std::string venueCode;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Performance& o)
+    {
+        fields(o, stream, "id", o.id, "eventId", o.eventId, "prices", o.prices,
+            "seatCategories", o.seatCategories, "start", o.start, "venueCode", o.venueCode);
+    }
+
+    struct Citm
+    {
+        std::map<std::string, std::string> areaNames;
+        std::map<std::string, Event> events;
+        std::vector<Performance> performances;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Citm& o)
+    {
+        fields(o, stream, "areaNames", o.areaNames, "events", o.events, "performances", o.performances);
+    }
+
+    inline Citm makeCitm(Random& rnd, int events, int performances)
+    {
+        Citm result;
+        for (auto i = 0; i != 20; ++i)
+            result.areaNames[std::to_string(205705993 + i)] = rnd.text(3);
+
+        for (auto i = 0; i != events; ++i)
+        {
+            Event e{138586341 + i, rnd.text(4), {}, {}};
+            for (auto n = 1 + rnd.uniform(5); n != 0; --n)
+                e.subTopicIds.push_back(337184262 + rnd.uniform(100));
+            e.topicIds.push_back(107888604 + rnd.uniform(10));
+            result.events[std::to_string(e.id)] = e;
+        }
+
+        for (auto i = 0; i != performances; ++i)
+        {
+            Performance p{339887544 + i, 138586341 + rnd.uniform(events), {}, {}, 1372701600000ll + rnd.uniform(1 << 30), "PLEYEL_PLEYEL"};
+            for (auto n = 1 + rnd.uniform(4); n != 0; --n)
+                p.prices.push_back(Price{rnd.uniform(200) * 1000, 337100890, 338937295 + rnd.uniform(10)});
+
+            for (auto n = 1 + rnd.uniform(3); n != 0; --n)
+            {
+                SeatCategory seats{{}, 338937295 + rnd.uniform(10)};
+                for (auto m = 1 + rnd.uniform(4); m != 0; --m)
+                    seats.areas.push_back(Area{205705993 + rnd.uniform(20), {}});
+                p.seatCategories.push_back(seats);
+            }
+            result.performances.push_back(p);
+        }
+        return result;
+    }
+
+    // Log lines: many small documents
+    struct LogLine
+    {
+        std::string timestamp;
+        std::string level;
+        std::string logger;
+        std::string message;
+        int thread;
+        std::string requestId;
+        double durationMs;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, LogLine& o)
+    {
+        fields(o, stream, "timestamp", o.timestamp, "level", o.level, "logger", o.logger, "message", o.message,
+            "thread", o.thread, "requestId", o.requestId, "durationMs", o.durationMs);
+    }
+
+    inline std::vector<LogLine> makeLogLines(Random& rnd, int count)
+    {
+        static const char* const levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+        std::vector<LogLine> result;
+        for (auto i = 0; i != count; ++i)
+        {
+            auto ms = 1000 * i + rnd.uniform(1000);
+            auto timestamp = "2014-08-31T00:" + std::to_string(10 + ms / 60000 % 50) + ":" + std::to_string(10 + ms / 1000 % 50)
+                + "." + std::to_string(100 + ms % 900) + "Z";
+
+            result.push_back(LogLine{timestamp, levels[rnd.uniform(4)], "com.example." + rnd.word(4, 10),
+                rnd.text(4 + rnd.uniform(12)), rnd.uniform(64), rnd.word(16, 16), rnd.uniform(100000) / 100.0});
+        }
+        return result;
+    }
+}
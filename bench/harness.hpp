@@ -0,0 +1,347 @@
+// JSON for C++ : benchmark harness
+// Belongs to the public domain
+
+#pragma once
+
+#include <json-cpp.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // Results of measured functions are accumulated here, so the compiler can't drop the calls
+    inline volatile std::size_t& sink()
+    {
+        static volatile std::size_t value;
+        return value;
+    }
+
+    struct Options
+    {
+        double minTime{0.5};
+        double warmupTime{0.05};
+        std::size_t minSamples{10};
+        std::string filter;
+
+        std::string saveFile;
+        std::string baselineFile;
+
+        // Allowed slowdown in percent, per-benchmark values are looked up by the longest name prefix
+        double tolerance{10};
+        std::map<std::string, double> tolerances;
+
+        double toleranceFor(const std::string& name) const
+        {
+            auto result = tolerance;
+            std::size_t matchLength = 0;
+            for (auto& entry : tolerances)
+            {
+                if (name.compare(0, entry.first.size(), entry.first) == 0 && entry.first.size() >= matchLength)
+                {
+                    result = entry.second;
+                    matchLength = entry.first.size();
+                }
+            }
+            return result;
+        }
+    };
+
+    // Time of one call in seconds
+    struct Sample
+    {
+        double median;
+        double mean;
+        double ciLow;
+        double ciHigh;
+        std::size_t samples;
+        std::size_t batch;
+    };
+
+    // Two-sided 95% Student's t quantile
+    inline double studentT95(std::size_t degreesOfFreedom)
+    {
+        static const double table[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+        };
+
+        if (degreesOfFreedom == 0)
+            return 0;
+
+        return degreesOfFreedom <= 30 ? table[degreesOfFreedom - 1] : 1.96;
+    }
+
+    // Runs `fn` for `warmupTime` to warm up caches and the allocator and to estimate its time.
+    // Then calls are grouped in batches long enough for the clock resolution,
+    // and batches are repeated for at least `minTime` seconds and at least `minSamples` times.
+    template<typename Fn>
+    inline Sample measure(Fn&& fn, const Options& options)
+    {
+        using Clock = std::chrono::steady_clock;
+        using Seconds = std::chrono::duration<double>;
+
+        std::size_t warmupCalls = 0;
+        auto warmupStart = Clock::now();
+        Seconds warmup{0};
+        do
+        {
+            sink() += fn();
+            ++warmupCalls;
+            warmup = Clock::now() - warmupStart;
+        }
+        while (warmup.count() < options.warmupTime);
+
+        auto minSamples = std::max<std::size_t>(options.minSamples, 2);
+        auto callTime = warmup.count() / warmupCalls;
+        auto sampleTime = options.minTime / minSamples;
+        auto batch = std::max<std::size_t>(1, static_cast<std::size_t>(sampleTime / callTime));
+
+        std::vector<double> samples;
+        auto total = 0.0;
+        while (total < options.minTime || samples.size() < minSamples)
+        {
+            auto start = Clock::now();
+            for (std::size_t i = 0; i != batch; ++i)
+                sink() += fn();
+            Seconds elapsed = Clock::now() - start;
+
+            samples.push_back(elapsed.count() / batch);
+            total += elapsed.count();
+        }
+
+        auto n = samples.size();
+        auto mean = 0.0;
+        for (auto x : samples)
+            mean += x;
+        mean /= n;
+
+        auto variance = 0.0;
+        for (auto x : samples)
+            variance += (x - mean) * (x - mean);
+        variance /= n - 1;
+
+        auto halfWidth = studentT95(n - 1) * std::sqrt(variance / n);
+
+        std::sort(samples.begin(), samples.end());
+        return Sample{samples[n / 2], mean, mean - halfWidth, mean + halfWidth, n, batch};
+    }
+
+    struct Result
+    {
+        std::string name;
+        std::size_t bytes;
+        std::size_t docs;
+        double seconds;
+        double ciLow;
+        double ciHigh;
+        double mbPerSec;
+        double docsPerSec;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Result& o)
+    {
+        fields(o, stream, "name", o.name, "bytes", o.bytes, "docs", o.docs, "seconds", o.seconds,
+            "ciLow", o.ciLow, "ciHigh", o.ciHigh, "mbPerSec", o.mbPerSec, "docsPerSec", o.docsPerSec);
+    }
+
+    struct Report
+    {
+        std::vector<Result> benchmarks;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Report& o)
+    {
+        fields(o, stream, "benchmarks", o.benchmarks);
+    }
+
+    class Runner
+    {
+    public:
+        explicit Runner(const Options& options) : m_options(options) {}
+
+        // `fn` processes `docs` documents of `bytes` total size and returns any value depending on the result,
+        // `seconds` is the median time of one call
+        template<typename Fn>
+        void run(const std::string& name, std::size_t bytes, std::size_t docs, Fn&& fn)
+        {
+            if (name.find(m_options.filter) == std::string::npos)
+                return;
+
+            auto s = measure(fn, m_options);
+            m_report.benchmarks.push_back(Result{name, bytes, docs, s.median, s.ciLow, s.ciHigh,
+                bytes / s.median / 1e6, docs / s.median});
+        }
+
+        const Report& report() const { return m_report; }
+
+    private:
+        Options m_options;
+        Report m_report;
+    };
+
+    template<typename T>
+    inline bool loadJson(const std::string& fileName, T& object)
+    {
+        std::ifstream file{fileName};
+        if (!file)
+        {
+            std::cerr << "Can't open " << fileName << '\n';
+            return false;
+        }
+
+        try
+        {
+            jsoncpp::parse(object, file);
+        }
+        catch (const jsoncpp::ParserError& e)
+        {
+            std::cerr << fileName << ": " << e.what() << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    inline Options parseOptions(int argc, char* argv[])
+    {
+        Options options;
+        for (auto i = 1; i < argc; ++i)
+        {
+            if (i + 1 < argc && std::strcmp(argv[i], "--filter") == 0)
+                options.filter = argv[++i];
+            else if (i + 1 < argc && std::strcmp(argv[i], "--min-time") == 0)
+                options.minTime = std::atof(argv[++i]);
+            else if (i + 1 < argc && std::strcmp(argv[i], "--warmup-time") == 0)
+                options.warmupTime = std::atof(argv[++i]);
+            else if (i + 1 < argc && std::strcmp(argv[i], "--samples") == 0)
+                options.minSamples = static_cast<std::size_t>(std::atoi(argv[++i]));
+            else if (i + 1 < argc && std::strcmp(argv[i], "--save") == 0)
+                options.saveFile = argv[++i];
+            else if (i + 1 < argc && std::strcmp(argv[i], "--compare") == 0)
+                options.baselineFile = argv[++i];
+            else if (i + 1 < argc && std::strcmp(argv[i], "--tolerance") == 0)
+                options.tolerance = std::atof(argv[++i]);
+            else if (i + 1 < argc && std::strcmp(argv[i], "--tolerances") == 0)
+            {
+                if (!loadJson(argv[++i], options.tolerances))
+                    std::exit(2);
+            }
+            else
+            {
+                std::cerr << "Usage: " << argv[0] << " [--filter SUBSTRING] [--min-time SECONDS]"
+                    " [--warmup-time SECONDS] [--samples N] [--save FILE] [--compare FILE]"
+                    " [--tolerance PERCENT] [--tolerances FILE]\n"
+                    "A tolerances file is a JSON object which maps benchmark name prefixes to percents.\n";
+                std::exit(2);
+            }
+        }
+        return options;
+    }
+
+    struct Comparison
+    {
+        std::string name;
+        std::string status;
+        double baseline;
+        double current;
+        double changePercent;
+        double tolerancePercent;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Comparison& o)
+    {
+        fields(o, stream, "name", o.name, "status", o.status, "baseline", o.baseline, "current", o.current,
+            "changePercent", o.changePercent, "tolerancePercent", o.tolerancePercent);
+    }
+
+    struct ComparisonReport
+    {
+        std::string baselineFile;
+        std::vector<Comparison> comparison;
+        int regressions;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, ComparisonReport& o)
+    {
+        fields(o, stream, "baselineFile", o.baselineFile, "comparison", o.comparison, "regressions", o.regressions);
+    }
+
+    // A benchmark has regressed if it is slower than the tolerance allows,
+    // and its confidence interval doesn't overlap with the baseline's one
+    inline ComparisonReport compare(const Report& baseline, const Report& current, const Options& options)
+    {
+        ComparisonReport report{options.baselineFile, {}, 0};
+        for (auto& result : current.benchmarks)
+        {
+            auto tolerance = options.toleranceFor(result.name);
+            auto it = std::find_if(baseline.benchmarks.begin(), baseline.benchmarks.end(),
+                [&result](const Result& r) { return r.name == result.name; });
+
+            if (it == baseline.benchmarks.end())
+            {
+                report.comparison.push_back(Comparison{result.name, "new", 0, result.seconds, 0, tolerance});
+                continue;
+            }
+
+            auto change = (result.seconds / it->seconds - 1) * 100;
+            std::string status = "ok";
+            if (change > tolerance && result.ciLow > it->ciHigh)
+            {
+                status = "regression";
+                ++report.regressions;
+            }
+            else if (change < -tolerance && result.ciHigh < it->ciLow)
+            {
+                status = "improvement";
+            }
+
+            report.comparison.push_back(Comparison{result.name, status, it->seconds, result.seconds, change, tolerance});
+        }
+        return report;
+    }
+
+    // Prints the results, saves them and compares them with the baseline.
+    // Returns the process exit code: 1 if there are regressions, 2 if files can't be read or written.
+    inline int finish(const Runner& runner, const Options& options)
+    {
+        std::cout << jsoncpp::to_string(runner.report()) << '\n';
+
+        if (!options.saveFile.empty())
+        {
+            std::ofstream file{options.saveFile};
+            jsoncpp::Generator<jsoncpp::details::Traits2<char, std::ostream>> stream{file};
+            serialize(stream, const_cast<Report&>(runner.report()));
+            file << '\n';
+            if (!file)
+            {
+                std::cerr << "Can't write " << options.saveFile << '\n';
+                return 2;
+            }
+        }
+
+        if (options.baselineFile.empty())
+            return 0;
+
+        Report baseline;
+        if (!loadJson(options.baselineFile, baseline))
+            return 2;
+
+        auto report = compare(baseline, runner.report(), options);
+        std::cout << jsoncpp::to_string(report) << '\n';
+        return report.regressions == 0 ? 0 : 1;
+    }
+}
@@ -0,0 +1,348 @@
+// JSON for C++ : parser and generator kernel benchmarks
+// Belongs to the public domain
+
+#include "harness.hpp"
+
+#include <json-cpp.hpp>
+#include <json-cpp/details/number_writer.hpp>
+#include <json-cpp/details/string_writer.hpp>
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using ParserT = jsoncpp::Parser<jsoncpp::details::Traits2<char, const char*>>;
+    using ReaderT = jsoncpp::details::Reader<const char*>;
+
+    const std::size_t Sizes[] = {8, 64, 512, 4 << 10, 32 << 10, 256 << 10, 1 << 20};
+
+    // At least one copy of the pattern, otherwise as many copies as fit in `size`
+    std::string repeat(const std::string& pattern, std::size_t size)
+    {
+        std::string result;
+        while (result.size() + pattern.size() <= size)
+            result += pattern;
+        if (result.empty())
+            result = pattern;
+        return result;
+    }
+
+    // A string literal body followed by the closing quote
+    template<typename StringT = std::string>
+    void benchParseString(bench::Runner& runner, const std::string& name, const std::string& pattern, bool validateUtf8 = false)
+    {
+        for (auto size : Sizes)
+        {
+            auto input = repeat(pattern, size - 1) + '"';
+            StringT str;
+            runner.run("parseString/" + name + "/" + std::to_string(size), input.size(), 1, [&]
+            {
+                ReaderT reader{input.data(), input.data() + input.size()};
+                jsoncpp::details::parseStringImpl(reader, str, validateUtf8);
+                return str.size();
+            });
+        }
+    }
+
+    // The same for UTF-16 input
+    template<typename StringT>
+    void benchParseUtf16String(bench::Runner& runner, const std::string& name, const std::u16string& pattern)
+    {
+        for (auto size : Sizes)
+        {
+            std::u16string input;
+            while (input.size() + pattern.size() <= size / 2 || input.empty())
+                input += pattern;
+            input += u'"';
+
+            StringT str;
+            runner.run("parseString/" + name + "/" + std::to_string(size), input.size() * 2, 1, [&]
+            {
+                jsoncpp::details::Reader<const char16_t*> reader{input.data(), input.data() + input.size()};
+                jsoncpp::details::parseStringImpl(reader, str);
+                return str.size();
+            });
+        }
+    }
+
+    // Comma-separated numbers terminated with ']'
+    template<typename ParseFn>
+    void benchParseNumbers(bench::Runner& runner, const std::string& name, const std::string& pattern, ParseFn parseFn)
+    {
+        for (auto size : Sizes)
+        {
+            auto input = repeat(pattern, size);
+            input.back() = ']';
+            runner.run("parseNumber/" + name + "/" + std::to_string(size), input.size(), 1, [&]
+            {
+                ReaderT reader{input.data(), input.data() + input.size()};
+                std::size_t result = 0;
+                for (;;)
+                {
+                    result += static_cast<std::size_t>(parseFn(reader));
+                    if (*reader == ']')
+                        return result;
+                    ++reader;
+                }
+            });
+        }
+    }
+
+    // Arrays of small numbers with 7 significant digits, like embedding vectors
+    template<typename T>
+    void benchParseVector(bench::Runner& runner, const std::string& name)
+    {
+        for (auto size : Sizes)
+        {
+            std::string input = "[";
+            unsigned seed = 1;
+            while (input.size() < size || input.size() == 1)
+            {
+                seed = seed * 1103515245 + 12345;
+                auto n = (seed >> 8) % 20000000;
+                input += (n % 2 ? "-0.0" : "0.0") + std::to_string(10000000 + n / 2).substr(1) + ",";
+            }
+            input.back() = ']';
+
+            std::vector<T> numbers;
+            runner.run("parseVector/" + name + "/" + std::to_string(size), input.size(), 1, [&]
+            {
+                jsoncpp::parse(numbers, input);
+                return numbers.size();
+            });
+        }
+    }
+
+    // Fresh containers are parsed every time, so their growth isn't amortized over the runs
+    void benchParseContainers(bench::Runner& runner, const std::string& name, bool reserveContainers)
+    {
+        jsoncpp::ParserOptions options;
+        options.reserveContainers = reserveContainers;
+
+        for (auto size : Sizes)
+        {
+            std::string arrayText = "[", objectText = "{";
+            for (auto i = 0; arrayText.size() < size || i == 0; ++i)
+            {
+                // Sorted, like keys of generated `std::map` data
+                auto item = "\"item" + std::to_string(1000000 + i) + "\"";
+                arrayText += item + ",";
+                objectText += item + ": " + std::to_string(i) + ",";
+            }
+            arrayText.back() = ']';
+            objectText.back() = '}';
+
+            runner.run("parseContainer/vector/" + name + "/" + std::to_string(size), arrayText.size(), 1, [&]
+            {
+                std::vector<std::string> strings;
+                jsoncpp::parse(strings, arrayText, options);
+                return strings.size();
+            });
+
+            runner.run("parseContainer/unordered_map/" + name + "/" + std::to_string(size), objectText.size(), 1, [&]
+            {
+                std::unordered_map<std::string, int> map;
+                jsoncpp::parse(map, objectText, options);
+                return map.size();
+            });
+
+            runner.run("parseContainer/map/" + name + "/" + std::to_string(size), objectText.size(), 1, [&]
+            {
+                std::map<std::string, int> map;
+                jsoncpp::parse(map, objectText, options);
+                return map.size();
+            });
+
+            runner.run("parseContainer/set/" + name + "/" + std::to_string(size), arrayText.size(), 1, [&]
+            {
+                std::set<std::string> set;
+                jsoncpp::parse(set, arrayText, options);
+                return set.size();
+            });
+        }
+    }
+
+    template<typename T>
+    void benchWriteVector(bench::Runner& runner, const std::string& name, const std::vector<T>& pattern)
+    {
+        for (auto size : Sizes)
+        {
+            std::vector<T> numbers;
+            for (std::size_t i = 0; numbers.size() * sizeof(T) < size; ++i)
+                numbers.push_back(pattern[i % pattern.size()]);
+
+            runner.run("writeVector/" + name + "/" + std::to_string(size), numbers.size() * sizeof(T), 1, [&]
+            {
+                return jsoncpp::to_string(numbers).size();
+            });
+        }
+    }
+
+    template<typename T>
+    void benchFormatNumbers(bench::Runner& runner, const std::string& name, const std::vector<T>& pattern)
+    {
+        for (auto size : Sizes)
+        {
+            std::vector<T> numbers;
+            for (std::size_t i = 0; numbers.size() * sizeof(T) < size; ++i)
+                numbers.push_back(pattern[i % pattern.size()]);
+
+            runner.run("formatNumber/" + name + "/" + std::to_string(size), numbers.size() * sizeof(T), numbers.size(), [&]
+            {
+                char buf[jsoncpp::details::MaxNumberLength];
+                std::size_t result = 0;
+                for (auto n : numbers)
+                    result += jsoncpp::details::formatNumber(buf, n);
+                return result;
+            });
+
+            std::ostringstream stream;
+            runner.run("ostreamNumber/" + name + "/" + std::to_string(size), numbers.size() * sizeof(T), numbers.size(), [&]
+            {
+                stream.str(std::string{});
+                for (auto n : numbers)
+                    stream << n;
+                return static_cast<std::size_t>(stream.tellp());
+            });
+        }
+    }
+
+    template<typename CharT>
+    void benchWriteString(bench::Runner& runner, const std::string& name, const std::basic_string<CharT>& pattern, bool escapeNonAscii)
+    {
+        for (auto size : Sizes)
+        {
+            std::basic_string<CharT> input;
+            while ((input.size() + pattern.size()) * sizeof(CharT) <= size)
+                input += pattern;
+            if (input.empty())
+                input = pattern;
+
+            std::string output;
+            runner.run("writeString/" + name + "/" + std::to_string(size), input.size() * sizeof(CharT), 1, [&]
+            {
+                output.clear();
+                jsoncpp::details::writeString(input, [&output](const char* data, std::size_t count) { output.append(data, count); }, escapeNonAscii);
+                return output.size();
+            });
+        }
+    }
+
+    struct Record
+    {
+        int id;
+        std::string name;
+        double price;
+        bool available;
+        std::vector<int> tags;
+        std::string description;
+        long long created;
+        std::string category;
+    };
+
+    void benchFieldsTable(bench::Runner& runner)
+    {
+        Record r;
+        jsoncpp::details::FieldsTable<ParserT> table{"id", r.id, "name", r.name, "price", r.price,
+            "available", r.available, "tags", r.tags, "description", r.description, "created", r.created, "category", r.category};
+
+        const std::vector<std::string> names = {"id", "name", "price", "available", "tags", "description", "created", "category", "unknown"};
+
+        for (auto size : Sizes)
+        {
+            std::vector<std::string> lookups;
+            std::size_t bytes = 0;
+            for (std::size_t i = 0; bytes < size; ++i)
+            {
+                lookups.push_back(names[i % names.size()]);
+                bytes += lookups.back().size();
+            }
+
+            runner.run("fieldsTableFind/" + std::to_string(size), bytes, lookups.size(), [&]
+            {
+                std::size_t result = 0;
+                for (auto& name : lookups)
+                    result += table.find(name) != nullptr;
+                return result;
+            });
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    auto options = bench::parseOptions(argc, argv);
+    bench::Runner runner{options};
+
+    for (auto size : Sizes)
+    {
+        auto input = repeat(" \n\t\r    ", size - 1) + '0';
+        runner.run("eatWhitespace/" + std::to_string(size), input.size(), 1, [&]
+        {
+            ParserT parser{input.data(), input.data() + input.size()};
+            return static_cast<std::size_t>(parser.getType());
+        });
+    }
+
+    benchParseString(runner, "ascii", "Lorem ipsum ");
+    benchParseString(runner, "escaped", "tab\\t quote\\\" line\\n slash\\\\ ");
+    benchParseString(runner, "surrogates", "\\uD83D\\uDE00\\u00E9");
+    benchParseString(runner, "ascii-validated", "Lorem ipsum ", true);
+    benchParseString(runner, "utf8", "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 ");
+    benchParseString(runner, "utf8-validated", "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 ", true);
+    benchParseString<std::u16string>(runner, "ascii-utf16", "Lorem ipsum ");
+    benchParseString<std::u16string>(runner, "utf8-utf16", "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 ");
+    benchParseString<std::u32string>(runner, "ascii-utf32", "Lorem ipsum ");
+    benchParseString<std::u32string>(runner, "utf8-utf32", "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 ");
+    benchParseUtf16String<std::u16string>(runner, "utf16-input", u"caf\u00e9 \u20ac \U0001F600 ");
+    benchParseUtf16String<std::string>(runner, "utf16-input-ascii", u"Lorem ipsum ");
+
+    benchParseNumbers(runner, "real", "3.14159,271828.5e-3,0.001,42,", [](ReaderT& reader) { return jsoncpp::details::parseRealNumber(reader); });
+
+    // The path of integral fields: the parser keeps the digits, which are converted exactly
+    jsoncpp::details::DecimalNumber decimal;
+    benchParseNumbers(runner, "integer", "7,1234567,89,100000,", [&decimal](ReaderT& reader)
+    {
+        jsoncpp::details::parseNumberImpl(reader, decimal);
+        jsoncpp::details::IntegerNumber number;
+        decimal.toInteger(number);
+        return number.magnitude;
+    });
+
+    benchParseVector<float>(runner, "float");
+    benchParseVector<double>(runner, "double");
+    benchParseContainers(runner, "reserved", true);
+    benchParseContainers(runner, "unreserved", false);
+
+    benchFieldsTable(runner);
+
+    for (auto size : Sizes)
+    {
+        auto input = repeat("Plain text with a \"quote\", a\ttab and a newline\n. ", size);
+        std::string output;
+        runner.run("writeString/" + std::to_string(size), input.size(), 1, [&]
+        {
+            output.clear();
+            jsoncpp::details::writeString(input, [&output](const char* data, std::size_t size) { output.append(data, size); });
+            return output.size();
+        });
+    }
+
+    benchWriteString(runner, "utf8-escaped", std::string{"Plain text with caf\xC3\xA9, a \"quote\" and \xE2\x82\xAC. "}, true);
+    benchWriteString(runner, "utf16", std::u16string{u"Plain text with caf\u00e9, a \"quote\" and \u20ac. "}, false);
+    benchWriteString(runner, "utf32", std::u32string{U"Plain text with caf\u00e9, a \"quote\" and \u20ac. "}, false);
+
+    benchWriteVector(runner, "integer", std::vector<long long>{0, 7, -42, 1234567, 9007199254740993ll});
+    benchWriteVector(runner, "double", std::vector<double>{0.1, -2.5, 3.14159265358979, 6.02214076e23, 1e-300});
+
+    benchFormatNumbers(runner, "integer", std::vector<long long>{0, 7, -42, 1234567, 9007199254740993ll});
+    benchFormatNumbers(runner, "double", std::vector<double>{0.1, -2.5, 3.14159265358979, 6.02214076e23, 1e-300});
+
+    return bench::finish(runner, options);
+}
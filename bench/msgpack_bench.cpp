@@ -0,0 +1,84 @@
+// JSON for C++ : MessagePack vs JSON benchmark
+// Belongs to the public domain
+
+#include <json-cpp.hpp>
+#include <json-cpp/msgpack.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Item
+    {
+        int id;
+        double price;
+        bool available;
+        std::string name;
+        std::vector<int> tags;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Item& o)
+    {
+        fields(o, stream, "id", o.id, "price", o.price, "available", o.available, "name", o.name, "tags", o.tags);
+    }
+
+    std::vector<Item> makeItems(std::size_t count)
+    {
+        std::vector<Item> items;
+        unsigned seed = 12345;
+        auto next = [&seed] { return seed = seed * 1103515245 + 12345, (seed >> 16) & 0x7FFF; };
+
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            Item item{static_cast<int>(i), next() / 100.0, next() % 2 == 0, "item #" + std::to_string(next()), {}};
+            for (auto n = next() % 8; n != 0; --n)
+                item.tags.push_back(static_cast<int>(next()));
+
+            items.push_back(item);
+        }
+
+        return items;
+    }
+
+    template<typename Fn>
+    double measure(int repeat, Fn fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i != repeat; ++i)
+            fn();
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / repeat;
+    }
+
+    void report(const char* name, std::size_t size, double writeMs, double readMs)
+    {
+        std::printf("%-8s %10zu bytes  write %8.3f ms  read %8.3f ms\n", name, size, writeMs, readMs);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    auto count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000ul;
+    const int repeat = 10;
+
+    auto items = makeItems(count);
+    std::vector<Item> result;
+
+    std::string json;
+    auto jsonWrite = measure(repeat, [&] { json = jsoncpp::to_string(items); });
+    auto jsonRead = measure(repeat, [&] { result.clear(); jsoncpp::parse(result, json); });
+    report("json", json.size(), jsonWrite, jsonRead);
+
+    std::string msgpack;
+    auto msgpackWrite = measure(repeat, [&] { msgpack = jsoncpp::to_msgpack(items); });
+    auto msgpackRead = measure(repeat, [&] { result.clear(); jsoncpp::parse_msgpack(result, msgpack); });
+    report("msgpack", msgpack.size(), msgpackWrite, msgpackRead);
+
+    return result.size() == items.size() ? 0 : 1;
+}
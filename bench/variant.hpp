@@ -0,0 +1,55 @@
+// JSON for C++ : DOM type for benchmarks
+// Belongs to the public domain
+
+#pragma once
+
+#include <json-cpp.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // The same Variant type as in tests/variant_example.cpp
+    struct Variant
+    {
+        jsoncpp::Type m_type{jsoncpp::Type::Undefined};
+        bool m_bool{false};
+        double m_number{0};
+        std::string m_string;
+        std::vector<Variant> m_array;
+        std::map<std::string, Variant> m_object;
+    };
+
+    template<class X>
+    void serialize(jsoncpp::Parser<X>& parser, Variant& v)
+    {
+        using jsoncpp::Type;
+        v.m_type = parser.getType();
+        switch (v.m_type)
+        {
+        case Type::Null: case Type::Undefined: return;
+        case Type::Boolean: serialize(parser, v.m_bool); return;
+        case Type::Number: serialize(parser, v.m_number); return;
+        case Type::String: serialize(parser, v.m_string); return;
+        case Type::Array: serialize(parser, v.m_array); return;
+        case Type::Object: serialize(parser, v.m_object); return;
+        }
+    }
+
+    template<class X>
+    void serialize(jsoncpp::Generator<X>& generator, Variant& v)
+    {
+        using jsoncpp::Type;
+        switch (v.m_type)
+        {
+        case Type::Undefined: case Type::Null: serialize(generator, nullptr); return;
+        case Type::Boolean: serialize(generator, v.m_bool); return;
+        case Type::Number: serialize(generator, v.m_number); return;
+        case Type::String: serialize(generator, v.m_string); return;
+        case Type::Array: serialize(generator, v.m_array); return;
+        case Type::Object: serialize(generator, v.m_object); return;
+        }
+    }
+}
@@ -5,4 +5,8 @@
 
 #include <json-cpp/parse.hpp>
 #include <json-cpp/std_types.hpp>
+#include <json-cpp/fixed_string.hpp>
 #include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/on_demand.hpp>
+#include <json-cpp/path.hpp>
+#include <json-cpp/projection.hpp>
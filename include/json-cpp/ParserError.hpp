@@ -26,6 +26,8 @@ namespace jsoncpp
             InvalidEscapeSequence, NoTrailSurrogate,
             UnexpectedType, UnknownField,
             NumberIsOutOfRange,
+            InvalidUtf8,
+            StringIsTooLong, WrongArraySize,
         };
 
         ParserError(Type type, std::size_t line, std::size_t column)
@@ -51,6 +53,9 @@ namespace jsoncpp
                 case UnexpectedType: m_what += ": unexpected value type"; break;
                 case UnknownField: m_what += ": unknown field name"; break;
                 case NumberIsOutOfRange: m_what += ": number is out of range"; break;
+                case InvalidUtf8: m_what += ": invalid UTF-8 sequence"; break;
+                case StringIsTooLong: m_what += ": string is too long"; break;
+                case WrongArraySize: m_what += ": wrong array size"; break;
                 case NoError:
                 default:
                     m_what += ": INTERNAL ERROR"; break;
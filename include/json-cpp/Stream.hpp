@@ -8,9 +8,12 @@ namespace jsoncpp
     template<class Traits>
     class Stream;
 
+    // Statistics policy which collects nothing, see stats.hpp
+    struct NoStats;
+
     namespace details
     {
-        template<typename CharT, class X>
+        template<typename CharT, class X, class StatsPolicy = NoStats>
         struct Traits2 {};
 
         template<class Traits>
@@ -0,0 +1,552 @@
+// JSON for C++ : CBOR (RFC 8949) parser and generator
+// Belongs to the public domain
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <json-cpp/ParserError.hpp>
+#include <json-cpp/Stream.hpp>
+#include <json-cpp/value_types.hpp>
+#include <json-cpp/parse.hpp>
+#include <json-cpp/generate.hpp>
+#include <json-cpp/string_ref.hpp>
+#include <json-cpp/details/parser_utility.hpp>
+#include <json-cpp/details/string_parser.hpp>
+#include <json-cpp/details/string_sink.hpp>
+
+namespace jsoncpp
+{
+    namespace details
+    {
+        // CBOR counterpart of Traits2, `T` is an input iterator for parsers and a sink for generators
+        template<typename T>
+        struct CborTraits {};
+
+        enum CborMajorType
+        {
+            CborUnsigned, CborNegative, CborBytes, CborText, CborArray, CborMap, CborTag, CborSimple,
+        };
+
+        const std::uint8_t CborFalse = 0xF4;
+        const std::uint8_t CborTrue = 0xF5;
+        const std::uint8_t CborNull = 0xF6;
+        const std::uint8_t CborFloat32 = 0xFA;
+        const std::uint8_t CborFloat64 = 0xFB;
+        const std::uint8_t CborBreak = 0xFF;
+        const std::uint8_t CborIndefinite = 31;
+        const std::uint64_t CborIndefiniteLength = ~std::uint64_t{0};
+
+        inline double cborHalfToDouble(unsigned half)
+        {
+            auto exponent = static_cast<int>((half >> 10) & 0x1F);
+            auto mantissa = static_cast<double>(half & 0x3FF);
+            auto value = exponent == 0 ? std::ldexp(mantissa, -24)
+                : exponent != 31 ? std::ldexp(mantissa + 1024, exponent - 25)
+                : mantissa == 0 ? INFINITY : NAN;
+            return (half & 0x8000) ? -value : value;
+        }
+    }
+
+    template<typename InputIterator>
+    class Stream<details::ParserTraits<details::CborTraits<InputIterator>>>
+    {
+    public:
+        using this_type = Parser<details::CborTraits<InputIterator>>;
+
+        explicit Stream(InputIterator first, InputIterator last)
+            : m_reader{first, last}
+        {
+            nextValue();
+        }
+
+        Type getType() const { return m_type; }
+        bool getBoolean() const { return m_boolean; }
+        double getNumber() const { return m_number; }
+        float getFloat() const { return static_cast<float>(m_number); }
+
+        // Integers are kept exactly, 64-bit values don't fit in a double
+        bool getInteger(details::IntegerNumber& number) const
+        {
+            if (!m_isInteger)
+                return details::doubleToInteger(m_number, number);
+
+            number = m_integer;
+            return true;
+        }
+        const std::string& getFieldName() const { return m_fieldName; }
+
+        const details::FieldMask* getFieldMask() const { return m_fieldMask; }
+        void setFieldMask(const details::FieldMask* mask) { m_fieldMask = mask; }
+
+        void checkType(Type type) const
+        {
+            if (getType() != type)
+                throw makeError(ParserError::UnexpectedType);
+        }
+
+        // Counted lists only, the count is checked against the input size if it's known
+        std::size_t listSizeHint() const
+        {
+            if ((m_type != Type::Array && m_type != Type::Object) || m_lists.back().remaining == details::CborIndefiniteLength)
+                return 0;
+
+            auto available = static_cast<std::uint64_t>(details::maxListSize(m_reader));
+            auto size = m_lists.back().remaining;
+            return static_cast<std::size_t>(size < available ? size : available);
+        }
+
+        // The terminator is ignored, CBOR lists are either counted or end with a "break" byte
+        bool isListEnd(char /*terminator*/)
+        {
+            auto& remaining = m_lists.back().remaining;
+            if (remaining == details::CborIndefiniteLength)
+            {
+                if (peekByte() != details::CborBreak)
+                    return false;
+
+                ++m_reader;
+            }
+            else if (remaining != 0)
+            {
+                return false;
+            }
+
+            m_lists.pop_back();
+            return true;
+        }
+
+        void eatListSeparator() {}
+
+        void nextNameValuePair()
+        {
+            consumeListItem();
+
+            auto initial = readByte();
+            if (initial >> 5 != details::CborText && initial >> 5 != details::CborBytes)
+                throw makeError(ParserError::UnexpectedType);
+
+            m_stringMajorType = initial >> 5;
+            m_stringLength = readLength(initial & 0x1F);
+            parseString(m_fieldName);
+
+            readItem();
+        }
+
+        void nextValue()
+        {
+            consumeListItem();
+            readItem();
+        }
+
+        template<typename DstCharT, class Traits, class Alloc>
+        void parseString(std::basic_string<DstCharT, Traits, Alloc>& str)
+        {
+            m_bytes.clear();
+            readStringBytes([this](char ch){ m_bytes.push_back(ch); });
+            assignString(str);
+        }
+
+        template<class Traits, class Alloc>
+        void parseString(std::basic_string<char, Traits, Alloc>& str)
+        {
+            str.clear();
+            readStringBytes([&str](char ch){ str.push_back(ch); });
+        }
+
+        ParserError makeError(ParserError::Type type) const
+        {
+            return m_reader.m_diag.makeError(type);
+        }
+
+        void skipValue()
+        {
+            switch (m_type)
+            {
+            case Type::String: readStringBytes([](char){}); break;
+            case Type::Array: case Type::Object: skipListRest(); break;
+            default: break;
+            }
+        }
+
+        void skipListRest()
+        {
+            auto isObject = m_lists.back().isObject;
+            while (!isListEnd(0))
+            {
+                if (isObject)
+                    nextNameValuePair();
+                else
+                    nextValue();
+
+                skipValue();
+            }
+        }
+
+    private:
+        struct List
+        {
+            std::uint64_t remaining;
+            bool isObject;
+        };
+
+        std::uint8_t peekByte()
+        {
+            m_reader.checkEnd();
+            return static_cast<std::uint8_t>(*m_reader);
+        }
+
+        std::uint8_t readByte()
+        {
+            auto byte = peekByte();
+            ++m_reader;
+            return byte;
+        }
+
+        std::uint64_t readBigEndian(int size)
+        {
+            std::uint64_t value = 0;
+            for (auto i = 0; i != size; ++i)
+                value = value << 8 | readByte();
+            return value;
+        }
+
+        std::uint64_t readArgument(std::uint8_t info)
+        {
+            if (info < 24)
+                return info;
+
+            switch (info)
+            {
+            case 24: return readBigEndian(1);
+            case 25: return readBigEndian(2);
+            case 26: return readBigEndian(4);
+            case 27: return readBigEndian(8);
+            }
+
+            throw makeError(ParserError::UnexpectedCharacter);
+        }
+
+        std::uint64_t readLength(std::uint8_t info)
+        {
+            return info == details::CborIndefinite ? details::CborIndefiniteLength : readArgument(info);
+        }
+
+        void consumeListItem()
+        {
+            if (!m_lists.empty() && m_lists.back().remaining != details::CborIndefiniteLength)
+                --m_lists.back().remaining;
+        }
+
+        void setNumber(double number)
+        {
+            m_number = number;
+            m_isInteger = false;
+            m_type = Type::Number;
+        }
+
+        void setInteger(bool negative, std::uint64_t magnitude)
+        {
+            m_integer = details::IntegerNumber{negative, magnitude};
+            m_number = negative ? -static_cast<double>(magnitude) : static_cast<double>(magnitude);
+            m_isInteger = true;
+            m_type = Type::Number;
+        }
+
+        void readItem()
+        {
+            for (;;)
+            {
+                auto initial = readByte();
+                auto info = static_cast<std::uint8_t>(initial & 0x1F);
+                switch (initial >> 5)
+                {
+                case details::CborUnsigned:
+                    return setInteger(false, readArgument(info));
+
+                // The value is -1 - n, -2^64 is out of the range of any integer type
+                case details::CborNegative:
+                    {
+                        auto n = readArgument(info);
+                        if (n == UINT64_MAX)
+                            return setNumber(-18446744073709551616.0);
+                        return setInteger(true, n + 1);
+                    }
+
+                case details::CborBytes: case details::CborText:
+                    m_stringMajorType = initial >> 5;
+                    m_stringLength = readLength(info);
+                    m_type = Type::String;
+                    return;
+
+                case details::CborArray: case details::CborMap:
+                    m_lists.push_back(List{readLength(info), initial >> 5 == details::CborMap});
+                    m_type = m_lists.back().isObject ? Type::Object : Type::Array;
+                    return;
+
+                case details::CborTag:
+                    readArgument(info);
+                    continue;
+                }
+
+                switch (initial)
+                {
+                case details::CborFalse: m_boolean = false; m_type = Type::Boolean; return;
+                case details::CborTrue: m_boolean = true; m_type = Type::Boolean; return;
+                case details::CborNull: case details::CborNull + 1: m_type = Type::Null; return;
+
+                case details::CborFloat32 - 1:
+                    return setNumber(details::cborHalfToDouble(static_cast<unsigned>(readBigEndian(2))));
+
+                case details::CborFloat32:
+                    {
+                        auto bits = static_cast<std::uint32_t>(readBigEndian(4));
+                        float value;
+                        std::memcpy(&value, &bits, sizeof(value));
+                        return setNumber(value);
+                    }
+
+                case details::CborFloat64:
+                    {
+                        auto bits = readBigEndian(8);
+                        double value;
+                        std::memcpy(&value, &bits, sizeof(value));
+                        return setNumber(value);
+                    }
+                }
+
+                throw makeError(ParserError::UnexpectedType);
+            }
+        }
+
+        template<typename Callback>
+        void readStringBytes(Callback&& callback)
+        {
+            if (m_stringLength != details::CborIndefiniteLength)
+            {
+                readChunk(m_stringLength, callback);
+                return;
+            }
+
+            while (peekByte() != details::CborBreak)
+            {
+                auto initial = readByte();
+                if (initial >> 5 != m_stringMajorType || (initial & 0x1F) == details::CborIndefinite)
+                    throw makeError(ParserError::UnexpectedType);
+
+                readChunk(readArgument(initial & 0x1F), callback);
+            }
+
+            ++m_reader;
+        }
+
+        template<typename Callback>
+        void readChunk(std::uint64_t size, Callback& callback)
+        {
+            for (; size != 0; --size)
+                callback(static_cast<char>(readByte()));
+        }
+
+        template<typename DstCharT, class Traits, class Alloc>
+        void assignString(std::basic_string<DstCharT, Traits, Alloc>& str)
+        {
+            str.clear();
+            details::utf8ToWide(m_bytes.data(), m_bytes.data() + m_bytes.size(), str);
+        }
+
+        details::Reader<InputIterator> m_reader;
+
+        Type m_type;
+        double m_number;
+        details::IntegerNumber m_integer;
+        bool m_isInteger{false};
+        bool m_boolean;
+        std::string m_fieldName;
+        const details::FieldMask* m_fieldMask{nullptr};
+
+        std::vector<List> m_lists;
+        std::uint64_t m_stringLength;
+        int m_stringMajorType;
+        std::string m_bytes;
+    };
+
+    template<typename Sink>
+    class Stream<details::GeneratorTraits<details::CborTraits<Sink>>>
+    {
+    public:
+        using this_type = Generator<details::CborTraits<Sink>>;
+
+        explicit Stream(Sink& sink) : m_sink(&sink) {}
+
+        // Objects and arrays are written with indefinite length,
+        // because the number of elements is not known in advance
+        void objectBegin() { writeByte(details::CborMap << 5 | details::CborIndefinite); }
+        void objectEnd() { writeByte(details::CborBreak); }
+        void arrayBegin() { writeByte(details::CborArray << 5 | details::CborIndefinite); }
+        void arrayEnd() { writeByte(details::CborBreak); }
+        void separator() {}
+
+        void fieldName(const char* name)
+        {
+            writeText(name, std::strlen(name));
+        }
+
+        template<typename StrCharT, class Traits, class Alloc>
+        void fieldName(const std::basic_string<StrCharT, Traits, Alloc>& name)
+        {
+            serialize(*this, name);
+        }
+
+        void fieldName(const StringRef& name)
+        {
+            writeText(name.data, name.size);
+        }
+
+        friend void serialize(this_type& stream, std::nullptr_t)
+        {
+            stream.writeByte(details::CborNull);
+        }
+
+        friend void serialize(this_type& stream, bool value)
+        {
+            stream.writeByte(value ? details::CborTrue : details::CborFalse);
+        }
+
+        template<typename T>
+        friend typename std::enable_if<std::is_arithmetic<T>::value>::type serialize(this_type& stream, T& value)
+        {
+            stream.writeNumber(value);
+        }
+
+        template<class Traits, class Alloc>
+        friend void serialize(this_type& stream, const std::basic_string<char, Traits, Alloc>& value)
+        {
+            stream.writeText(value.data(), value.size());
+        }
+
+        template<typename SrcCharT, class Traits, class Alloc>
+        friend void serialize(this_type& stream, const std::basic_string<SrcCharT, Traits, Alloc>& value)
+        {
+            std::string utf8;
+            details::wideToUtf8(value, utf8);
+            serialize(stream, utf8);
+        }
+
+        friend void serialize(this_type& stream, StringRef& value)
+        {
+            stream.writeText(value.data, value.size);
+        }
+
+    private:
+        void writeByte(std::uint8_t byte)
+        {
+            m_sink->put(static_cast<char>(byte));
+        }
+
+        void writeBigEndian(std::uint8_t initial, std::uint64_t value, int size)
+        {
+            char buf[9];
+            buf[0] = static_cast<char>(initial);
+            for (auto i = size; i != 0; --i, value >>= 8)
+                buf[i] = static_cast<char>(value & 0xFF);
+
+            m_sink->write(buf, static_cast<std::size_t>(size + 1));
+        }
+
+        void writeHeader(int majorType, std::uint64_t value)
+        {
+            auto initial = static_cast<std::uint8_t>(majorType << 5);
+            if (value < 24)
+                writeByte(static_cast<std::uint8_t>(initial | value));
+            else if (value <= 0xFF)
+                writeBigEndian(initial | 24, value, 1);
+            else if (value <= 0xFFFF)
+                writeBigEndian(initial | 25, value, 2);
+            else if (value <= 0xFFFFFFFF)
+                writeBigEndian(initial | 26, value, 4);
+            else
+                writeBigEndian(initial | 27, value, 8);
+        }
+
+        void writeText(const char* str, std::size_t size)
+        {
+            writeHeader(details::CborText, size);
+            m_sink->write(str, size);
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_integral<T>::value>::type writeNumber(T value)
+        {
+            if (value >= 0)
+                writeHeader(details::CborUnsigned, static_cast<std::uint64_t>(value));
+            else
+                writeHeader(details::CborNegative, static_cast<std::uint64_t>(-(value + 1)));
+        }
+
+        void writeNumber(float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeBigEndian(details::CborFloat32, bits, 4);
+        }
+
+        void writeNumber(double value)
+        {
+            auto asFloat = static_cast<float>(value);
+            if (asFloat == value || value != value)
+            {
+                writeNumber(asFloat);
+                return;
+            }
+
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeBigEndian(details::CborFloat64, bits, 8);
+        }
+
+        void writeNumber(long double value)
+        {
+            writeNumber(static_cast<double>(value));
+        }
+
+        Sink* m_sink;
+    };
+
+    template<class T>
+    inline std::string to_cbor(const T& object)
+    {
+        std::string result;
+        details::StringSink sink{result};
+        Generator<details::CborTraits<details::StringSink>> stream{sink};
+        serialize(stream, const_cast<T&>(object));
+        return result;
+    }
+
+    template<class T, typename InputIterator>
+    inline void parse_cbor(T& object, InputIterator first, InputIterator last)
+    {
+        Parser<details::CborTraits<InputIterator>> stream{first, last};
+        serialize(stream, object);
+    }
+
+    template<class T>
+    inline void parse_cbor(T& object, const std::string& data)
+    {
+        parse_cbor(object, data.data(), data.data() + data.size());
+    }
+
+    template<class T>
+    inline void parse_cbor(T& object, std::istream& stream)
+    {
+        std::istreambuf_iterator<char> first{stream}, last;
+        parse_cbor(object, first, last);
+    }
+}
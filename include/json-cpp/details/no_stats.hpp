@@ -0,0 +1,47 @@
+// JSON for C++ : implementation, default statistics policy
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+#include <typeinfo>
+
+#include <json-cpp/Stream.hpp>
+#include <json-cpp/value_types.hpp>
+
+namespace jsoncpp
+{
+    // Every hook is empty, so the statistics code is compiled out
+    struct NoStats
+    {
+        void value(Type) {}
+        void listEnd() {}
+        void parsedString(std::size_t /*length*/, bool /*grew*/) {}
+        template<typename Str> void writtenString(const Str&) {}
+        void skipped() {}
+        int profileBegin() { return 0; }
+        void profileEnd(int, const std::type_info&, const char* /*field*/) {}
+    };
+
+    namespace details
+    {
+        // Streams without a statistics policy
+        template<class X>
+        inline NoStats streamStats(Stream<X>&)
+        {
+            return{};
+        }
+
+        template<typename CharT, typename Iterator, class StatsPolicy>
+        inline StatsPolicy& streamStats(Parser<Traits2<CharT, Iterator, StatsPolicy>>& parser)
+        {
+            return parser.stats();
+        }
+
+        template<typename CharT, typename Sink, class StatsPolicy>
+        inline StatsPolicy& streamStats(Generator<Traits2<CharT, Sink, StatsPolicy>>& generator)
+        {
+            return generator.stats();
+        }
+    }
+}
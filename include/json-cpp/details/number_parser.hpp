@@ -3,76 +3,396 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <json-cpp/ParserError.hpp>
+#include <json-cpp/details/parser_utility.hpp>
+#include <json-cpp/details/simd.hpp>
 
 namespace jsoncpp { namespace details
 {
-    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    template<typename CharT>
+    inline bool isDigit(CharT c) { return c >= '0' && c <= '9'; }
 
-    template<typename Iterator>
-    inline unsigned parseIntNumber(Iterator& iter)
+    inline char* writeDigits(char* out, std::uint64_t n)
     {
-        auto intPart = 0U; // TBD: 0ULL ?
-
+        char buf[20];
+        auto p = buf + sizeof(buf);
         do
         {
-            intPart = intPart * 10 + (*iter - '0');
-
-            ++iter;
+            *--p = static_cast<char>('0' + n % 10);
+            n /= 10;
         }
-        while (isDigit(*iter));
+        while (n != 0);
+        return std::copy(p, buf + sizeof(buf), out);
+    }
+
+    // An integer number which is converted to the target type exactly, or not at all
+    struct IntegerNumber
+    {
+        bool negative;
+        std::uint64_t magnitude;
+    };
+
+    // Range checks come before the conversion, so there's no overflow
+    template<typename T>
+    inline ParserError::Type toInteger(const IntegerNumber& number, T& value)
+    {
+        using U = typename std::make_unsigned<T>::type;
+
+        auto limit = !number.negative ? static_cast<std::uint64_t>(std::numeric_limits<T>::max())
+            : std::is_signed<T>::value ? static_cast<std::uint64_t>(0 - static_cast<U>(std::numeric_limits<T>::min())) : 0;
+        if (number.magnitude > limit)
+            return ParserError::NumberIsOutOfRange;
 
-        return intPart;
+        // The minimum of a signed type has no positive counterpart
+        auto n = static_cast<U>(number.magnitude);
+        value = !number.negative || n == 0 ? static_cast<T>(n) : static_cast<T>(-static_cast<T>(n - 1) - 1);
+        return ParserError::NoError;
     }
 
-    template<typename Iterator>
-    inline double parseRealNumber(Iterator& iter)
+    // Formats with integers in them store floating point numbers as well, only whole numbers are integers
+    inline bool doubleToInteger(double value, IntegerNumber& number)
     {
-        double number = 0;
+        if (!(std::floor(value) == value) || std::fabs(value) >= 18446744073709551616.0)
+            return false;
 
-        if (*iter == '0')
+        number.negative = value < 0;
+        number.magnitude = static_cast<std::uint64_t>(std::fabs(value));
+        return true;
+    }
+
+    template<typename Float> struct FastPathLimits;
+
+    // Clinger's fast path: the significand and the power of ten are exact doubles, so there's only one rounding
+    template<> struct FastPathLimits<double>
+    {
+        static const std::uint64_t maxSignificand = std::uint64_t{1} << 53;
+        static const int maxExponent = 22;
+        static double fromText(const char* text) { return std::strtod(text, nullptr); }
+    };
+
+    // The significand and the power of ten are exact floats, and rounding the double result to float gives
+    // the correctly rounded float, because 53 >= 2 * 24 + 2 bits (Figueroa, "When is double rounding innocuous?")
+    template<> struct FastPathLimits<float>
+    {
+        static const std::uint64_t maxSignificand = std::uint64_t{1} << 24;
+        static const int maxExponent = 10;
+        static float fromText(const char* text) { return std::strtof(text, nullptr); }
+    };
+
+    // Decimal digits of a JSON number, they are converted to a binary floating point type on demand,
+    // so both `double` and `float` get the correctly rounded value
+    struct DecimalNumber
+    {
+        // Longer significands are truncated, but a dropped nonzero digit is remembered,
+        // it's enough to round any double correctly
+        static const std::size_t MaxDigits = 768;
+
+        // The first digits are accumulated in `significand`, only the rest is stored as text
+        static const std::size_t SignificandDigits = 19;
+
+        bool negative{false};
+        bool truncated{false};
+        std::size_t size{0};            // significant digits, without leading zeros
+        int exponent{0};                // the value is `digits * 10^exponent`
+        std::uint64_t significand{0};   // the first 19 digits
+        char extraDigits[MaxDigits - SignificandDigits];
+
+        template<typename Float>
+        Float to() const
         {
-            ++iter;
+            using Limits = FastPathLimits<Float>;
+
+            Float value = 0;
+            if (size == 0)
+            {
+            }
+            else if (FLT_EVAL_METHOD == 0 && size <= SignificandDigits && significand <= Limits::maxSignificand
+                && exponent >= -Limits::maxExponent && exponent <= Limits::maxExponent)
+            {
+                static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+                auto n = static_cast<double>(significand);
+                value = static_cast<Float>(exponent < 0 ? n / powers[-exponent] : n * powers[exponent]);
+            }
+            else
+            {
+                // Locale-independent, there's no decimal point
+                char text[MaxDigits + 16];
+                auto out = writeDigits(text, significand);
+                out = std::copy(extraDigits, extraDigits + (size > SignificandDigits ? size - SignificandDigits : 0), out);
+                auto e = exponent;
+                if (truncated)
+                {
+                    *out++ = '1';
+                    --e;
+                }
+
+                *out++ = 'e';
+                if (e < 0)
+                    *out++ = '-';
+
+                out = writeDigits(out, e < 0 ? 0U - static_cast<unsigned>(e) : static_cast<unsigned>(e));
+                *out = 0;
+
+                value = Limits::fromText(text);
+            }
+
+            return negative ? -value : value;
         }
-        else
+
+        // Returns false if the number has a fraction or doesn't fit in 64 bits.
+        // Zeros after the decimal point are allowed, e.g. `1.0` and `1e2` are integers.
+        bool toInteger(IntegerNumber& result) const
         {
-            number = parseIntNumber(iter);
+            result.negative = negative;
+            result.magnitude = 0;
+            if (size == 0)
+                return true;
+
+            // There are more than 768 significant digits
+            if (truncated)
+                return false;
+
+            auto n = significand;
+            auto e = exponent;
+            auto extraCount = size > SignificandDigits ? size - SignificandDigits : 0;
+            auto fractionDigits = exponent < 0 ? static_cast<std::size_t>(-static_cast<long long>(exponent)) : 0;
+
+            // Extra digits of the integer part are appended, the ones of the fraction must be zeros
+            for (std::size_t i = 0; i != extraCount; ++i)
+            {
+                auto digit = static_cast<unsigned>(extraDigits[i] - '0');
+                if (extraCount - i <= fractionDigits)
+                {
+                    if (digit != 0)
+                        return false;
+                    ++e;
+                }
+                else
+                {
+                    if (n > (UINT64_MAX - digit) / 10)
+                        return false;
+                    n = n * 10 + digit;
+                }
+            }
+
+            for (; e < 0; ++e)
+            {
+                if (n % 10 != 0)
+                    return false;
+                n /= 10;
+            }
+
+            for (; e > 0; --e)
+            {
+                if (n > UINT64_MAX / 10)
+                    return false;
+                n *= 10;
+            }
+
+            result.magnitude = n;
+            return true;
         }
+    };
 
-        // here `ch` is a peeked character, need to call eat()
+    // Contiguous input without the per-character checks of `Reader`, the end reads as a null character
+    template<typename CharT>
+    struct BoundedPtr
+    {
+        CharT operator*() const { return ptr != end ? *ptr : CharT{}; }
+        BoundedPtr& operator++() { ++ptr; return *this; }
+
+        const CharT* ptr;
+        const CharT* end;
+    };
+
+    // Only contiguous `char` input is read in blocks, see below
+    template<typename Iterator>
+    inline bool parseEightDigits(Iterator&, std::uint64_t&)
+    {
+        return false;
+    }
+
+#if defined JSONCPP_INTERNAL_LITTLE_ENDIAN
+    // Appends eight digits to `n` at once, if the next eight characters are digits
+    inline bool parseEightDigits(BoundedPtr<char>& iter, std::uint64_t& n)
+    {
+        if (iter.end - iter.ptr < 8)
+            return false;
+
+        std::uint64_t chunk;
+        std::memcpy(&chunk, iter.ptr, sizeof(chunk));
+
+        // Each byte is 0x30..0x39, i.e. its high nibble is 3 and adding 6 doesn't carry into it
+        const auto high = 0xF0F0F0F0F0F0F0F0ULL;
+        if ((chunk & high) != 0x3030303030303030ULL || ((chunk + 0x0606060606060606ULL) & high) != 0x3030303030303030ULL)
+            return false;
+
+        // Pairs, then quads are combined with multiplications
+        chunk -= 0x3030303030303030ULL;
+        chunk = chunk * 10 + (chunk >> 8);
+        chunk = ((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))
+            + ((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
 
-        if (*iter == '.')
+        n = n * 100000000 + (chunk & 0xFFFFFFFF);
+        iter.ptr += 8;
+        return true;
+    }
+#endif
+
+    // Parses a number which starts at `input`, the conversion is delayed until the target type is known.
+    // The state is kept in local variables, so it stays in registers.
+    template<typename Iterator>
+    inline ParserError::Type parseNumberImpl(Iterator& input, DecimalNumber& number)
+    {
+        auto iter = input;
+        std::uint64_t significand = 0;
+        std::size_t size = 0;
+        auto exponent = 0;
+        auto truncated = false;
+
+        auto parseDigits = [&](bool isFraction)
         {
-            ++iter;
+            // Blocks are tried only at the start of the run, short numbers would fail every attempt
+            while ((size != 0 || *iter != '0') && size + 8 <= DecimalNumber::SignificandDigits
+                && parseEightDigits(iter, significand))
+            {
+                size += 8;
+                exponent -= isFraction ? 8 : 0;
+            }
 
-            auto mul = 0.1;
             while (isDigit(*iter))
             {
-                number += (*iter - '0') * mul;
-                mul /= 10;
+                auto digit = static_cast<unsigned>(*iter - '0');
                 ++iter;
+
+                if (size < DecimalNumber::SignificandDigits)
+                {
+                    // Leading zeros are skipped
+                    if (size != 0 || digit != 0)
+                    {
+                        significand = significand * 10 + digit;
+                        ++size;
+                    }
+                    exponent -= isFraction;
+                }
+                else if (size != DecimalNumber::MaxDigits)
+                {
+                    number.extraDigits[size++ - DecimalNumber::SignificandDigits] = static_cast<char>('0' + digit);
+                    exponent -= isFraction;
+                }
+                else
+                {
+                    truncated |= digit != 0;
+                    exponent += !isFraction;
+                }
             }
-        }
+        };
 
-        // here `ch` is a peeked character, need to call eat()
+        auto err = ParserError::NoError;
+        auto negative = *iter == '-';
+        if (negative)
+            ++iter;
+
+        if (*iter == '0')
+            ++iter;
+        else if (isDigit(*iter))
+            parseDigits(false);
+        else
+            err = ParserError::UnexpectedCharacter;
 
-        if (*iter == 'e' || *iter == 'E')
+        if (err == ParserError::NoError && *iter == '.')
+        {
+            ++iter;
+            if (isDigit(*iter))
+                parseDigits(true);
+            else
+                err = ParserError::UnexpectedCharacter;
+        }
+
+        if (err == ParserError::NoError && (*iter == 'e' || *iter == 'E'))
         {
             ++iter;
 
             auto negate = *iter == '-';
             if (negate || *iter == '+')
                 ++iter;
-            // FIXME: check `ch` for non-digit
 
-            auto e = parseIntNumber(iter);
+            if (!isDigit(*iter))
+                err = ParserError::UnexpectedCharacter;
 
-            if (negate)
-                number /= std::pow(10, e);
-            else
-                number *= std::pow(10, e);
+            // Saturated, anything larger is out of range of any floating point type anyway
+            auto e = 0;
+            for (; isDigit(*iter); ++iter)
+            {
+                if (e < 100000000)
+                    e = e * 10 + (*iter - '0');
+            }
+
+            exponent += negate ? -e : e;
+        }
+
+        number.negative = negative;
+        number.truncated = truncated;
+        number.size = size;
+        number.exponent = exponent;
+        number.significand = significand;
+        input = iter;
+        return err;
+    }
+
+    template<typename CharT>
+    inline ParserError::Type parseNumberImpl(Reader<const CharT*>& reader, DecimalNumber& number)
+    {
+        BoundedPtr<CharT> iter{reader.m_iter, reader.m_end};
+        auto err = parseNumberImpl(iter, number);
+        reader.m_diag.nextColumns(static_cast<std::size_t>(iter.ptr - reader.m_iter));
+        reader.m_iter = iter.ptr;
+        return err;
+    }
+
+    // Parses an integer map key, it's a field name with decimal digits and an optional minus sign.
+    // Keys are already parsed strings, so there's no allocation.
+    template<typename T>
+    inline ParserError::Type parseIntegerKey(const char* iter, const char* last, T& value)
+    {
+        IntegerNumber number{iter != last && *iter == '-', 0};
+        if (number.negative)
+            ++iter;
+
+        if (iter == last)
+            return ParserError::UnexpectedCharacter;
+
+        auto overflow = false;
+        for (; iter != last; ++iter)
+        {
+            if (!isDigit(*iter))
+                return ParserError::UnexpectedCharacter;
+
+            auto digit = static_cast<unsigned>(*iter - '0');
+            overflow |= number.magnitude > (UINT64_MAX - digit) / 10;
+            number.magnitude = number.magnitude * 10 + digit;
         }
 
-        return number;
+        return overflow ? ParserError::NumberIsOutOfRange : toInteger(number, value);
+    }
+
+    template<typename Iterator>
+    inline double parseRealNumber(Iterator& iter)
+    {
+        DecimalNumber number;
+        parseNumberImpl(iter, number);
+        return number.to<double>();
     }
-}}
\ No newline at end of file
+}}
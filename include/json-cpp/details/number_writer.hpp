@@ -3,6 +3,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <clocale>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <ostream>
+#include <type_traits>
+
 namespace jsoncpp { namespace details
 {
     template<class RawStream>
@@ -10,4 +19,113 @@ namespace jsoncpp { namespace details
     {
         sink << number;
     }
+
+    // Enough for any integer and for "%g" formatted floating point numbers
+    const std::size_t MaxNumberLength = 32;
+
+    // Formats a number the same way as a default-configured std::ostream does
+    template<typename T>
+    inline typename std::enable_if<std::is_integral<T>::value, std::size_t>::type
+        formatNumber(char* buf, T value)
+    {
+        using U = typename std::make_unsigned<T>::type;
+        auto negative = value < 0;
+        auto n = negative ? static_cast<U>(0 - static_cast<U>(value)) : static_cast<U>(value);
+
+        char digits[MaxNumberLength];
+        auto end = digits + MaxNumberLength;
+        auto first = end;
+        do
+        {
+            *--first = static_cast<char>('0' + n % 10);
+            n /= 10;
+        }
+        while (n != 0);
+
+        auto out = buf;
+        if (negative)
+            *out++ = '-';
+
+        while (first != end)
+            *out++ = *first++;
+
+        return static_cast<std::size_t>(out - buf);
+    }
+
+    // `snprintf` writes the decimal point of the global C locale (LC_NUMERIC), JSON always has '.'
+    inline std::size_t fixDecimalPoint(char* buf, std::size_t size)
+    {
+        auto point = std::localeconv()->decimal_point;
+        if (point[0] == '.' && point[1] == 0)
+            return size;
+
+        auto pointSize = std::strlen(point);
+        auto pos = std::search(buf, buf + size, point, point + pointSize);
+        if (pointSize == 0 || pos == buf + size)
+            return size;
+
+        *pos = '.';
+        std::copy(pos + pointSize, buf + size, pos + 1);
+        return size - (pointSize - 1);
+    }
+
+    inline std::size_t formatNumber(char* buf, double value)
+    {
+        return fixDecimalPoint(buf, static_cast<std::size_t>(std::snprintf(buf, MaxNumberLength, "%g", value)));
+    }
+
+    inline std::size_t formatNumber(char* buf, float value)
+    {
+        return formatNumber(buf, static_cast<double>(value));
+    }
+
+    inline std::size_t formatNumber(char* buf, long double value)
+    {
+        return fixDecimalPoint(buf, static_cast<std::size_t>(std::snprintf(buf, MaxNumberLength, "%Lg", value)));
+    }
+
+    // Formats numbers separated by ", " in a buffer, which is passed to `write(const char* data, std::size_t size)`
+    // when it's full
+    template<typename T, typename Write>
+    inline void writeNumbers(const T* numbers, std::size_t size, Write&& write)
+    {
+        char buf[4096];
+        std::size_t used = 0;
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            if (used > sizeof(buf) - MaxNumberLength - 2)
+            {
+                write(static_cast<const char*>(buf), used);
+                used = 0;
+            }
+
+            if (i != 0)
+            {
+                buf[used++] = ',';
+                buf[used++] = ' ';
+            }
+
+            used += formatNumber(buf + used, numbers[i]);
+        }
+
+        if (used != 0)
+            write(static_cast<const char*>(buf), used);
+    }
+
+    // Tells if a sink formats numbers like `formatNumber`, so batches of numbers can be written with `writeNumbers`
+    template<class Sink>
+    struct NumberFormat
+    {
+        static bool isDefault(const Sink&) { return false; }
+    };
+
+    template<>
+    struct NumberFormat<std::ostream>
+    {
+        static bool isDefault(const std::ostream& stream)
+        {
+            return stream.flags() == (std::ios_base::dec | std::ios_base::skipws) && stream.precision() == 6
+                && stream.getloc() == std::locale::classic();
+        }
+    };
 }}
@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <type_traits>
 #include <utility>
 
 #include <json-cpp/ParserError.hpp>
+#include <json-cpp/details/simd.hpp>
 
 namespace jsoncpp { namespace details
 {
@@ -49,6 +52,7 @@ namespace jsoncpp { namespace details
     {
     public:
         void nextColumn() { ++m_column; }
+        void nextColumns(std::size_t count) { m_column += count; }
         void newLine() { ++m_line; m_column = 0; }
 
         ParserError makeError(ParserError::Type type) const
@@ -61,17 +65,42 @@ namespace jsoncpp { namespace details
         std::size_t m_line{1};
     };
 
+    template<class T>
+    inline const void* typeTag()
+    {
+        static const char tag{};
+        return &tag;
+    }
+
+    // Selects the fields to parse for one particular object, see `Projection`
+    struct FieldMask
+    {
+        const void* object;
+        const void* objectType;
+        const void* const* fields;
+        std::size_t size;
+        bool stopWhenFilled;
+
+        template<class T>
+        bool isFor(const T& obj) const { return object == &obj && objectType == typeTag<T>(); }
+
+        bool contains(const void* field) const { return std::find(fields, fields + size, field) != fields + size; }
+    };
+
     template<typename InputIterator>
     struct Reader
     {
         using this_type = Reader<InputIterator>;
 
+        // Code units are bytes of UTF-8, or UTF-16 or UTF-32 code units for wide input
+        using char_type = typename std::decay<decltype(*std::declval<InputIterator&>())>::type;
+
         Reader(InputIterator first, InputIterator last) : m_iter(first), m_end(last)
         {
             checkEnd();
         }
 
-        char operator*() { return *m_iter; }
+        char_type operator*() { return *m_iter; }
         this_type& operator++()
         {
             checkEnd();
@@ -86,7 +115,7 @@ namespace jsoncpp { namespace details
                 throw m_diag.makeError(ParserError::Eof);
         }
 
-        char getNextChar()
+        char_type getNextChar()
         {
             auto prev = *m_iter;
             ++*this;
@@ -96,4 +125,104 @@ namespace jsoncpp { namespace details
         Diagnostics m_diag;
         InputIterator m_iter, m_end;
     };
+
+    // Only contiguous input is scanned ahead, see below
+    template<typename InputIterator>
+    inline std::size_t countListItems(const Reader<InputIterator>&)
+    {
+        return 0;
+    }
+
+    // Counts the items of the array or object which starts at the reader by its separators, for reserving.
+    // Strings and nested lists are skipped. Returns 0 if the list doesn't end or has comments in it,
+    // the commas of a comment would be counted. The count is only a hint.
+    inline std::size_t countListItems(const Reader<const char*>& reader)
+    {
+        auto iter = reader.m_iter, last = reader.m_end;
+        while (iter != last && (*iter == ' ' || *iter == '\t' || *iter == '\n' || *iter == '\r'))
+            ++iter;
+
+        if (iter == last || *iter == ']' || *iter == '}')
+            return 0;
+
+        std::size_t commas = 0;
+        std::size_t depth = 0;
+        auto inString = false;
+        auto hasComment = false;
+        const char* escaped = nullptr;
+
+        // Returns true at the end of the list
+        auto next = [&](const char* ch)
+        {
+            if (ch == escaped)
+                return false;
+
+            switch (*ch)
+            {
+            case '\\': if (inString) escaped = ch + 1; break;
+            case '"': inString = !inString; break;
+            case '[': case '{': depth += !inString; break;
+            case ',': commas += !inString && depth == 0; break;
+
+            case '/':
+                if (inString)
+                    break;
+                hasComment = true;
+                return true;
+
+            case ']': case '}':
+                if (inString)
+                    break;
+                if (depth == 0)
+                    return true;
+                --depth;
+                break;
+            }
+            return false;
+        };
+
+#if defined JSONCPP_INTERNAL_SSE2
+        // Only the characters above are looked at, brackets and braces differ by one bit
+        while (last - iter >= 16)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iter));
+            auto brackets = _mm_or_si128(block, _mm_set1_epi8(0x20));
+            auto specials = _mm_or_si128(_mm_cmpeq_epi8(brackets, _mm_set1_epi8('{')), _mm_cmpeq_epi8(brackets, _mm_set1_epi8('}')));
+            specials = _mm_or_si128(specials, _mm_cmpeq_epi8(block, _mm_set1_epi8(',')));
+            specials = _mm_or_si128(specials, _mm_cmpeq_epi8(block, _mm_set1_epi8('"')));
+            specials = _mm_or_si128(specials, _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+            specials = _mm_or_si128(specials, _mm_cmpeq_epi8(block, _mm_set1_epi8('/')));
+
+            for (auto mask = static_cast<unsigned>(_mm_movemask_epi8(specials)); mask != 0; mask &= mask - 1)
+            {
+                if (next(iter + countTrailingZeros(mask)))
+                    return hasComment ? 0 : commas + 1;
+            }
+
+            iter += 16;
+        }
+#endif
+
+        for (; iter != last; ++iter)
+        {
+            if (next(iter))
+                return hasComment ? 0 : commas + 1;
+        }
+
+        return 0;
+    }
+
+    // The input size is unknown, so nothing is reserved for list sizes read from headers
+    template<typename InputIterator>
+    inline std::size_t maxListSize(const Reader<InputIterator>&)
+    {
+        return 0;
+    }
+
+    // Every item takes at least one code unit, so longer lists in headers are malformed
+    template<typename CharT>
+    inline std::size_t maxListSize(const Reader<const CharT*>& reader)
+    {
+        return static_cast<std::size_t>(reader.m_end - reader.m_iter);
+    }
 }}
@@ -0,0 +1,42 @@
+// JSON for C++ : implementation, SIMD support
+// Belongs to the public domain
+
+#pragma once
+
+// Vectorized kernels are used if the target has SSE2, they have scalar fallbacks otherwise
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define JSONCPP_INTERNAL_SSE2
+#endif
+
+// SWAR kernels load several characters into one integer, the first character must be the lowest byte
+#if defined _M_IX86 || defined _M_X64 || defined _M_ARM64 || (defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#   define JSONCPP_INTERNAL_LITTLE_ENDIAN
+#endif
+
+namespace jsoncpp { namespace details
+{
+    inline unsigned countTrailingZeros(unsigned bits)
+    {
+#if defined __GNUC__
+        return static_cast<unsigned>(__builtin_ctz(bits));
+#else
+        auto count = 0U;
+        for (; (bits & 1) == 0; bits >>= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    inline unsigned countOnes(unsigned bits)
+    {
+#if defined __GNUC__
+        return static_cast<unsigned>(__builtin_popcount(bits));
+#else
+        auto count = 0U;
+        for (; bits != 0; bits &= bits - 1)
+            ++count;
+        return count;
+#endif
+    }
+}}
@@ -3,135 +3,258 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <type_traits>
 
 #include <json-cpp/ParserError.hpp>
+#include <json-cpp/details/parser_utility.hpp>
+#include <json-cpp/details/simd.hpp>
+#include <json-cpp/details/unicode.hpp>
 
 namespace jsoncpp { namespace details
 {
-    inline char32_t utf16SurrogatePairToUtf32(char32_t lead, char32_t trail)
+    template<typename Iterator>
+    inline int parseHexDigit(Iterator& iter, ParserError::Type& err)
     {
-        return 0x10000 | (lead - 0xD800) << 10 | (trail - 0xDC00);
+        auto ch = *iter;
+        ++iter;
+        if (ch >= '0' && ch <= '9') return ch - '0';
+        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+        
+        err = ParserError::InvalidEscapeSequence;
+        return 0;
     }
 
-    inline void utf32ToUtf8(char32_t c, std::string& str)
+    template<typename Iterator>
+    inline char32_t parseUTF16CodeUnit(Iterator& iter, ParserError::Type& err)
     {
-        auto add = [&str](char32_t c){ str.push_back(static_cast<char>(c)); };
+        auto n = parseHexDigit(iter, err) << 12;
+        n |= parseHexDigit(iter, err) << 8;
+        n |= parseHexDigit(iter, err) << 4;
+        n |= parseHexDigit(iter, err);
+        return static_cast<char32_t>(n);
+    }
 
-        if (c < 0x80)
-        {
-            add(c);
-        }
-        else if (c < 0x800)
-        {
-            add(0xC0 | c >> 6);
-            add(0x80 | (c & 0x3f));
-        }
-        else if (c < 0x10000)
-        {
-            add(0xE0 | c >> 12);
-            add(0x80 | ((c >> 6) & 0x3f));
-            add(0x80 | (c & 0x3f));
-        }
-        else if (c < 0x200000)
+    template<typename Iterator>
+    inline void skipStringImpl(Iterator& iter)
+    {
+        for (;;)
         {
-            add(0xF0 | c >> 18);
-            add(0x80 | ((c >> 12) & 0x3f));
-            add(0x80 | ((c >> 6) & 0x3f));
-            add(0x80 | (c & 0x3f));
+            auto ch = *iter;
+            ++iter;
+            if (ch == '"')
+                return;
+
+            if (ch == '\\')
+                ++iter;
         }
-        else if (c < 0x4000000)
+    }
+
+    // Returns the end of the run of string bytes which need no decoding: it stops at a quote or a backslash,
+    // and, if `stopAtNonAscii` is set, at a non-ASCII byte. Scans 16 bytes at a time with SSE2.
+    inline const char* findPlainEnd(const char* iter, const char* last, bool stopAtNonAscii)
+    {
+#if defined JSONCPP_INTERNAL_SSE2
+        const auto quote = _mm_set1_epi8('"');
+        const auto backslash = _mm_set1_epi8('\\');
+        const auto highBit = _mm_set1_epi8(stopAtNonAscii ? static_cast<char>(0x80) : 0);
+        while (last - iter >= 16)
         {
-            add(0xF8 | c >> 24);
-            add(0x80 | ((c >> 18) & 0x3f));
-            add(0x80 | ((c >> 12) & 0x3f));
-            add(0x80 | ((c >> 6) & 0x3f));
-            add(0x80 | (c & 0x3f));
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iter));
+            auto stops = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash));
+            stops = _mm_or_si128(stops, _mm_and_si128(block, highBit));
+
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(stops));
+            if (mask != 0)
+                return iter + countTrailingZeros(mask);
+
+            iter += 16;
         }
-        else
+#endif
+
+        for (; iter != last; ++iter)
         {
-            add(0xFC | c >> 30);
-            add(0x80 | ((c >> 24) & 0x3f));
-            add(0x80 | ((c >> 18) & 0x3f));
-            add(0x80 | ((c >> 12) & 0x3f));
-            add(0x80 | ((c >> 6) & 0x3f));
-            add(0x80 | (c & 0x3f));
+            if (*iter == '"' || *iter == '\\')
+                break;
+            if (stopAtNonAscii && !isAscii(*iter))
+                break;
         }
+        return iter;
+    }
+
+    // Only contiguous input has a fast path, see below
+    template<typename Iterator, class Str>
+    inline void copyPlainRun(Iterator&, Str&, bool)
+    {
     }
 
-    enum class CharType { Raw, CodePoint, UTF16Pair };
+    // Appends the run of bytes which need no decoding, non-ASCII sequences are validated in place if required.
+    // The run stops before a malformed sequence, so the caller can report it at its exact position.
+    template<class Str>
+    inline typename std::enable_if<sizeof(typename Str::value_type) == 1>::type
+        copyPlainRun(Reader<const char*>& reader, Str& str, bool validateUtf8)
+    {
+        auto first = reader.m_iter, iter = first, last = reader.m_end;
+        for (;;)
+        {
+            iter = findPlainEnd(iter, last, validateUtf8);
+            if (!validateUtf8 || iter == last || isAscii(*iter))
+                break;
+
+            auto sequence = iter;
+            char32_t c;
+            if (!decodeSequence(iter, last, c))
+            {
+                iter = sequence;
+                break;
+            }
+        }
 
-    template<typename CharT, std::size_t CharSize>
-    inline void addToStr(std::basic_string<CharT>& str, CharType type, char32_t c1, char32_t c2);
+        str.append(first, iter);
+        reader.m_iter = iter;
+        reader.m_diag.nextColumns(static_cast<std::size_t>(iter - first));
+    }
 
-    template<>
-    inline void addToStr<char, 1>(std::basic_string<char>& str, CharType type, char32_t c1, char32_t c2)
+    // Transcodes the run into a UTF-16 or UTF-32 string: ASCII is widened in bulk, other sequences one by one
+    template<class Str>
+    inline typename std::enable_if<(sizeof(typename Str::value_type) > 1)>::type
+        copyPlainRun(Reader<const char*>& reader, Str& str, bool)
     {
-        if (type == CharType::Raw)
+        auto first = reader.m_iter, iter = first, last = reader.m_end;
+        for (;;)
         {
-            str.push_back(static_cast<char>(c1));
+            auto runEnd = findPlainEnd(iter, last, true);
+            widenAscii(iter, runEnd, str);
+            iter = runEnd;
+            if (iter == last || isAscii(*iter))
+                break;
+
+            auto sequence = iter;
+            char32_t c;
+            if (!decodeSequence(iter, last, c))
+            {
+                iter = sequence;
+                break;
+            }
+            addCodePoint(str, c);
         }
-        else if (type == CharType::CodePoint)
+
+        reader.m_iter = iter;
+        reader.m_diag.nextColumns(static_cast<std::size_t>(iter - first));
+    }
+
+    // Returns the end of the run of UTF-16 code units which need no decoding: it stops at a quote, a backslash,
+    // a surrogate, and, if `stopAtNonAscii` is set, at a non-ASCII character. Scans 8 units at a time with SSE2.
+    template<typename CharT>
+    inline const CharT* findPlainEnd(const CharT* iter, const CharT* last, bool stopAtNonAscii)
+    {
+#if defined JSONCPP_INTERNAL_SSE2
+        if (sizeof(CharT) == 2)
         {
-            utf32ToUtf8(c1, str);
+            const auto quote = _mm_set1_epi16('"');
+            const auto backslash = _mm_set1_epi16('\\');
+            const auto surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+            const auto surrogateMask = _mm_set1_epi16(static_cast<short>(0xF800));
+            const auto nonAsciiMask = _mm_set1_epi16(stopAtNonAscii ? -0x80 : 0);
+            const auto zero = _mm_setzero_si128();
+            while (last - iter >= 8)
+            {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iter));
+                auto stops = _mm_or_si128(_mm_cmpeq_epi16(block, quote), _mm_cmpeq_epi16(block, backslash));
+                stops = _mm_or_si128(stops, _mm_cmpeq_epi16(_mm_and_si128(block, surrogateMask), surrogate));
+                auto ascii = _mm_cmpeq_epi16(_mm_and_si128(block, nonAsciiMask), zero);
+
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(stops, _mm_xor_si128(ascii, _mm_cmpeq_epi16(zero, zero)))));
+                if (mask != 0)
+                    return iter + countTrailingZeros(mask) / 2;
+
+                iter += 8;
+            }
         }
-        else
+#endif
+
+        for (; iter != last; ++iter)
         {
-            auto c32 = utf16SurrogatePairToUtf32(c1, c2);
-            utf32ToUtf8(c32, str);
+            auto c = static_cast<char32_t>(*iter);
+            if (c == '"' || c == '\\' || (c >= 0xD800 && c < 0xE000))
+                break;
+            if (stopAtNonAscii && c >= 0x80)
+                break;
         }
+        return iter;
     }
 
-    template<>
-    inline void addToStr<wchar_t, 2>(std::basic_string<wchar_t>& str, CharType type, char32_t c1, char32_t c2)
+    // Contiguous UTF-16 input: runs are copied as is into UTF-16 strings, and ASCII runs are narrowed for `char` strings
+    template<typename InputCharT, class Str>
+    inline void copyPlainRun(Reader<const InputCharT*>& reader, Str& str, bool)
     {
-        str.push_back(static_cast<wchar_t>(c1));
-        if (type == CharType::UTF16Pair)
-            str.push_back(static_cast<wchar_t>(c2));
-    }
+        using CharT = typename Str::value_type;
 
-    template<>
-    inline void addToStr<wchar_t, 4>(std::basic_string<wchar_t>& str, CharType type, char32_t c1, char32_t c2)
-    {
-        auto c = (type == CharType::UTF16Pair) ? utf16SurrogatePairToUtf32(c1, c2) : c1;
-        str.push_back(static_cast<wchar_t>(c));
-    }
+        if (sizeof(InputCharT) != 2 || sizeof(CharT) > 2)
+            return;
 
-    template<typename Iterator>
-    inline int parseHexDigit(Iterator& iter, ParserError::Type& err)
-    {
-        auto ch = *iter;
-        ++iter;
-        if (ch >= '0' && ch <= '9') return ch - '0';
-        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
-        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
-        
-        err = ParserError::InvalidEscapeSequence;
-        return 0;
-    }
+        auto first = reader.m_iter, last = reader.m_end;
+        auto iter = findPlainEnd(first, last, sizeof(CharT) == 1);
+        auto size = static_cast<std::size_t>(iter - first);
+        if (size == 0)
+            return;
 
-    template<typename Iterator>
-    inline char32_t parseUTF16CodeUnit(Iterator& iter, ParserError::Type& err)
-    {
-        auto n = parseHexDigit(iter, err) << 12;
-        n |= parseHexDigit(iter, err) << 8;
-        n |= parseHexDigit(iter, err) << 4;
-        n |= parseHexDigit(iter, err);
-        return static_cast<char32_t>(n);
+        if (sizeof(CharT) == 2)
+        {
+            str.append(reinterpret_cast<const CharT*>(first), size);
+        }
+        else
+        {
+            auto offset = str.size();
+            str.resize(offset + size);
+            narrowAscii(first, iter, reinterpret_cast<char*>(&str[offset]));
+        }
+
+        reader.m_iter = iter;
+        reader.m_diag.nextColumns(size);
     }
 
-    template<typename Iterator, typename CharT>
-    inline ParserError::Type parseStringImpl(Iterator& iter, std::basic_string<CharT>& str)
+    // Input is UTF-8, or UTF-16 or UTF-32 for wide characters, and it's transcoded to the encoding of the string.
+    // Malformed sequences and lone surrogates are replaced with U+FFFD. If `validateUtf8` is set, malformed UTF-8
+    // is an error instead, and on `InvalidUtf8` the iterator points to the offending byte.
+    // `Str` is a `std::basic_string` or another string with the same members, e.g. `FixedString`
+    template<typename Iterator, class Str>
+    inline ParserError::Type parseStringImpl(Iterator& iter, Str& str, bool validateUtf8 = false)
     {
+        using CharT = typename Str::value_type;
+        using InputCharT = typename std::decay<decltype(*iter)>::type;
+
         str.clear();
         auto add = [&str](CharType type, char32_t c1, char32_t c2)
         {
             addToStr<CharT, sizeof(CharT)>(str, type, c1, c2);
         };
 
+        auto decode = sizeof(InputCharT) == 1 && (validateUtf8 || sizeof(CharT) > 1);
+
+        Utf8Decoder utf8;
         for (;;)
         {
+            if (utf8.isComplete())
+                copyPlainRun(iter, str, validateUtf8);
+
             auto ch = static_cast<char32_t>(*iter);
+            if (decode && !utf8.next(static_cast<unsigned char>(*iter)))
+            {
+                if (validateUtf8)
+                    return ParserError::InvalidUtf8;
+
+                // The byte after a truncated sequence is decoded again
+                auto isTruncated = !utf8.isComplete();
+                utf8.reset();
+                add(CharType::CodePoint, 0xFFFD, 0);
+                if (!isTruncated)
+                    ++iter;
+                continue;
+            }
+
             ++iter;
             if (ch == '"')
                 return ParserError::NoError;
@@ -184,7 +307,33 @@ namespace jsoncpp { namespace details
                 }
             }
 
-            add(CharType::Raw, ch, 0);
+            if (ch < 0x80 || (sizeof(InputCharT) == 1 && sizeof(CharT) == 1))
+            {
+                add(CharType::Raw, ch, 0);
+            }
+            else if (sizeof(InputCharT) == 1)
+            {
+                if (utf8.isComplete())
+                    addCodePoint(str, utf8.codePoint());
+            }
+            else if (sizeof(InputCharT) == 2 && ch >= 0xD800 && ch < 0xDC00)
+            {
+                auto trail = static_cast<char32_t>(*iter);
+                if (trail >= 0xDC00 && trail < 0xE000)
+                {
+                    ++iter;
+                    add(CharType::UTF16Pair, ch, trail);
+                }
+                else
+                {
+                    add(CharType::CodePoint, 0xFFFD, 0);
+                }
+            }
+            else
+            {
+                auto isValid = ch < 0xD800 || (ch >= 0xE000 && ch <= 0x10FFFF);
+                addCodePoint(str, isValid ? ch : 0xFFFD);
+            }
         }
     }
 }}
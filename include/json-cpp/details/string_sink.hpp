@@ -0,0 +1,21 @@
+// JSON for C++ : implementation, sink appending to a string
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace jsoncpp { namespace details
+{
+    // Minimal sink for binary generators, avoids iostream overhead
+    struct StringSink
+    {
+        explicit StringSink(std::string& str) : m_str(&str) {}
+
+        void put(char ch) { m_str->push_back(ch); }
+        void write(const char* data, std::size_t size) { m_str->append(data, size); }
+
+        std::string* m_str;
+    };
+}}
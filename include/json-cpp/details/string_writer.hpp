@@ -3,43 +3,189 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <string>
 
+#include <json-cpp/details/simd.hpp>
+#include <json-cpp/details/unicode.hpp>
+
 namespace jsoncpp { namespace details
 {
-    template<typename SrcCharT, typename Sink>
-    inline void writeString(const std::basic_string<SrcCharT>& str, Sink&& sink)
+    // Collects small pieces of output, so `write(const char* data, std::size_t size)` gets large chunks
+    template<typename Write>
+    class ChunkedOutput
     {
-        sink('"');
-        for (auto iter = std::begin(str), last = std::end(str); iter != last; ++iter)
+    public:
+        explicit ChunkedOutput(Write& write) : m_write(write) {}
+
+        void push_back(char ch)
         {
-            switch (char32_t ch = static_cast<unsigned char>(*iter))
+            if (m_size == sizeof(m_data))
+                flush();
+            m_data[m_size++] = ch;
+        }
+
+        void append(const char* first, const char* last)
+        {
+            auto size = static_cast<std::size_t>(last - first);
+            if (size > sizeof(m_data) - m_size)
             {
-            case '"': sink('\\'); sink('"'); break;
-            case '\\': sink('\\'); sink('\\'); break;
-            case '\b': sink('\\'); sink('b'); break;
-            case '\f': sink('\\'); sink('f'); break;
-            case '\n': sink('\\'); sink('n'); break;
-            case '\r': sink('\\'); sink('r'); break;
-            case '\t': sink('\\'); sink('t'); break;
-            default:
-                if (ch < '\x20')
+                flush();
+                if (size >= sizeof(m_data))
                 {
-                    const auto table = "0123456789ABCDEF";
-                    unsigned n = static_cast<unsigned char>(ch);
-                    sink('\\');
-                    sink('u');
-                    sink('0');
-                    sink('0');
-                    sink(table[n >> 4]);
-                    sink(table[n & 15]);
+                    m_write(first, size);
+                    return;
+                }
+            }
+
+            std::memcpy(m_data + m_size, first, size);
+            m_size += size;
+        }
+
+        // ASCII characters of a wide string
+        template<typename CharT>
+        void append(const CharT* first, const CharT* last)
+        {
+            while (first != last)
+            {
+                if (m_size == sizeof(m_data))
+                    flush();
+
+                auto count = std::min(static_cast<std::size_t>(last - first), sizeof(m_data) - m_size);
+                narrowAscii(first, first + count, m_data + m_size);
+                first += count;
+                m_size += count;
+            }
+        }
+
+        void flush()
+        {
+            if (m_size != 0)
+                m_write(static_cast<const char*>(m_data), m_size);
+            m_size = 0;
+        }
+
+    private:
+        Write& m_write;
+        char m_data[256];
+        std::size_t m_size{0};
+    };
+
+    // Returns the end of the run of characters which are written as is: printable ASCII except quote and backslash,
+    // and also non-ASCII bytes if `stopAtNonAscii` isn't set. Scans 16 bytes at a time with SSE2.
+    template<typename CharT>
+    inline const CharT* findVerbatimEnd(const CharT* iter, const CharT* last, bool stopAtNonAscii)
+    {
+        auto isVerbatim = [stopAtNonAscii](CharT ch)
+        {
+            if (!isAscii(ch))
+                return sizeof(CharT) == 1 && !stopAtNonAscii;
+            return ch >= 0x20 && ch != '"' && ch != '\\';
+        };
+
+#if defined JSONCPP_INTERNAL_SSE2
+        // Mask bits of the lowest bytes of characters, other bytes of ASCII characters are zero
+        auto lowBytes = 0U;
+        for (std::size_t i = 0; i != 16; i += sizeof(CharT))
+            lowBytes |= 1U << i;
+
+        const auto perBlock = 16 / sizeof(CharT);
+        while (static_cast<std::size_t>(last - iter) >= perBlock)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iter));
+
+            // Matches in non-ASCII characters are masked out
+            auto specials = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+            auto controls = _mm_cmplt_epi8(block, _mm_set1_epi8(0x20));
+            auto ascii = asciiMask<sizeof(CharT)>(block);
+
+            auto stops = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(specials, controls))) & ascii & lowBytes;
+            if (sizeof(CharT) > 1 || stopAtNonAscii)
+                stops |= ~ascii & lowBytes;
+
+            if (stops != 0)
+                return iter + countTrailingZeros(stops) / sizeof(CharT);
+
+            iter += perBlock;
+        }
+#endif
+
+        while (iter != last && isVerbatim(*iter))
+            ++iter;
+        return iter;
+    }
+
+    template<class Output>
+    inline void writeEscapedCodeUnit(Output& out, char32_t n)
+    {
+        const auto table = "0123456789ABCDEF";
+        out.push_back('\\');
+        out.push_back('u');
+        out.push_back(table[(n >> 12) & 15]);
+        out.push_back(table[(n >> 8) & 15]);
+        out.push_back(table[(n >> 4) & 15]);
+        out.push_back(table[n & 15]);
+    }
+
+    // Writes a string literal with `write(const char* data, std::size_t size)`.
+    // Wide strings are transcoded from UTF-16 (2-byte characters) or UTF-32 (4-byte characters) to UTF-8.
+    // If `escapeNonAscii` is set, non-ASCII characters are written as `\u` escapes, so the output is pure ASCII,
+    // `char` strings are decoded from UTF-8 for that. Malformed input is written as U+FFFD then.
+    template<typename SrcCharT, typename Write>
+    inline void writeString(const SrcCharT* first, std::size_t size, Write&& write, bool escapeNonAscii = false)
+    {
+        ChunkedOutput<Write> out{write};
+        out.push_back('"');
+
+        for (auto iter = first, last = first + size;;)
+        {
+            auto runEnd = findVerbatimEnd(iter, last, escapeNonAscii);
+            out.append(iter, runEnd);
+            iter = runEnd;
+            if (iter == last)
+                break;
+
+            if (!isAscii(*iter))
+            {
+                auto c = nextCodePoint(iter, last);
+                if (!escapeNonAscii)
+                {
+                    utf32ToUtf8(c, out);
+                }
+                else if (c < 0x10000)
+                {
+                    writeEscapedCodeUnit(out, c);
                 }
                 else
                 {
-                    sink(static_cast<char>(ch));
+                    writeEscapedCodeUnit(out, 0xD800 + ((c - 0x10000) >> 10));
+                    writeEscapedCodeUnit(out, 0xDC00 + (c & 0x3FF));
                 }
+                continue;
+            }
+
+            switch (auto ch = static_cast<char>(*iter++))
+            {
+            case '"': out.push_back('\\'); out.push_back('"'); break;
+            case '\\': out.push_back('\\'); out.push_back('\\'); break;
+            case '\b': out.push_back('\\'); out.push_back('b'); break;
+            case '\f': out.push_back('\\'); out.push_back('f'); break;
+            case '\n': out.push_back('\\'); out.push_back('n'); break;
+            case '\r': out.push_back('\\'); out.push_back('r'); break;
+            case '\t': out.push_back('\\'); out.push_back('t'); break;
+            default: writeEscapedCodeUnit(out, static_cast<char32_t>(ch)); break;
             }
         }
-        sink('"');
+
+        out.push_back('"');
+        out.flush();
+    }
+
+    template<typename SrcCharT, typename Write>
+    inline void writeString(const std::basic_string<SrcCharT>& str, Write&& write, bool escapeNonAscii = false)
+    {
+        writeString(str.data(), str.size(), write, escapeNonAscii);
     }
 }}
@@ -0,0 +1,351 @@
+// JSON for C++ : implementation, Unicode transcoding
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <json-cpp/details/simd.hpp>
+
+namespace jsoncpp { namespace details
+{
+    inline char32_t utf16SurrogatePairToUtf32(char32_t lead, char32_t trail)
+    {
+        return 0x10000 | (lead - 0xD800) << 10 | (trail - 0xDC00);
+    }
+
+    template<class Str>
+    inline void utf32ToUtf8(char32_t c, Str& str)
+    {
+        auto add = [&str](char32_t c){ str.push_back(static_cast<char>(c)); };
+
+        if (c < 0x80)
+        {
+            add(c);
+        }
+        else if (c < 0x800)
+        {
+            add(0xC0 | c >> 6);
+            add(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x10000)
+        {
+            add(0xE0 | c >> 12);
+            add(0x80 | ((c >> 6) & 0x3f));
+            add(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x200000)
+        {
+            add(0xF0 | c >> 18);
+            add(0x80 | ((c >> 12) & 0x3f));
+            add(0x80 | ((c >> 6) & 0x3f));
+            add(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x4000000)
+        {
+            add(0xF8 | c >> 24);
+            add(0x80 | ((c >> 18) & 0x3f));
+            add(0x80 | ((c >> 12) & 0x3f));
+            add(0x80 | ((c >> 6) & 0x3f));
+            add(0x80 | (c & 0x3f));
+        }
+        else
+        {
+            add(0xFC | c >> 30);
+            add(0x80 | ((c >> 24) & 0x3f));
+            add(0x80 | ((c >> 18) & 0x3f));
+            add(0x80 | ((c >> 12) & 0x3f));
+            add(0x80 | ((c >> 6) & 0x3f));
+            add(0x80 | (c & 0x3f));
+        }
+    }
+
+    enum class CharType { Raw, CodePoint, UTF16Pair };
+
+    // UTF-8 for `char`, UTF-16 for 2-byte characters, and UTF-32 for 4-byte characters.
+    // `Str` is a `std::basic_string` or another string with `push_back`.
+    template<typename CharT, std::size_t CharSize, class Str>
+    inline void addToStr(Str& str, CharType type, char32_t c1, char32_t c2)
+    {
+        static_assert(CharSize == 1 || CharSize == 2 || CharSize == 4, "unsupported character size");
+        if (CharSize == 1)
+        {
+            if (type == CharType::Raw)
+                str.push_back(static_cast<CharT>(c1));
+            else
+                utf32ToUtf8(type == CharType::CodePoint ? c1 : utf16SurrogatePairToUtf32(c1, c2), str);
+            return;
+        }
+
+        if (CharSize == 4 && type == CharType::UTF16Pair)
+        {
+            str.push_back(static_cast<CharT>(utf16SurrogatePairToUtf32(c1, c2)));
+            return;
+        }
+
+        str.push_back(static_cast<CharT>(c1));
+        if (type == CharType::UTF16Pair)
+            str.push_back(static_cast<CharT>(c2));
+    }
+
+    template<class Str>
+    inline void addCodePoint(Str& str, char32_t c)
+    {
+        using CharT = typename Str::value_type;
+        if (sizeof(CharT) == 2 && c >= 0x10000)
+            addToStr<CharT, sizeof(CharT)>(str, CharType::UTF16Pair, 0xD800 + ((c - 0x10000) >> 10), 0xDC00 + (c & 0x3FF));
+        else
+            addToStr<CharT, sizeof(CharT)>(str, CharType::CodePoint, c, 0);
+    }
+
+    // Decodes bytes one by one, accepting only the well-formed UTF-8 sequences of the Unicode Standard, table 3-7:
+    // overlong forms, surrogates, code points above U+10FFFF and truncated sequences are rejected
+    class Utf8Decoder
+    {
+    public:
+        // Returns false if the byte can't start or continue a sequence, the state isn't changed then
+        bool next(unsigned char byte)
+        {
+            if (m_pending == 0)
+            {
+                if (byte < 0x80) return expect(0, byte, 0x80, 0xBF);
+                if (byte < 0xC2) return false;
+                if (byte < 0xE0) return expect(1, byte & 0x1F, 0x80, 0xBF);
+                if (byte < 0xF0) return expect(2, byte & 0x0F, byte == 0xE0 ? 0xA0 : 0x80, byte == 0xED ? 0x9F : 0xBF);
+                if (byte < 0xF5) return expect(3, byte & 0x07, byte == 0xF0 ? 0x90 : 0x80, byte == 0xF4 ? 0x8F : 0xBF);
+                return false;
+            }
+
+            if (byte < m_low || byte > m_high)
+                return false;
+
+            --m_pending;
+            m_codePoint = m_codePoint << 6 | (byte & 0x3F);
+            m_low = 0x80;
+            m_high = 0xBF;
+            return true;
+        }
+
+        bool isComplete() const { return m_pending == 0; }
+
+        // The last decoded code point, if the sequence is complete
+        char32_t codePoint() const { return m_codePoint; }
+
+        void reset() { expect(0, 0, 0x80, 0xBF); }
+
+    private:
+        bool expect(int pending, char32_t bits, unsigned char low, unsigned char high)
+        {
+            m_pending = pending;
+            m_codePoint = bits;
+            m_low = low;
+            m_high = high;
+            return true;
+        }
+
+        int m_pending{0};
+        char32_t m_codePoint{0};
+        unsigned char m_low{0x80};
+        unsigned char m_high{0xBF};
+    };
+
+    template<typename CharT>
+    inline bool isAscii(CharT ch)
+    {
+        return static_cast<typename std::make_unsigned<CharT>::type>(ch) < 0x80;
+    }
+
+    // Decodes the sequence at `iter` and moves past it. A malformed sequence is skipped
+    // up to the first byte which can't continue it, but at least one byte is skipped.
+    inline bool decodeSequence(const char*& iter, const char* last, char32_t& codePoint)
+    {
+        Utf8Decoder utf8;
+        auto first = iter;
+        while (iter != last && utf8.next(static_cast<unsigned char>(*iter)))
+        {
+            ++iter;
+            if (utf8.isComplete())
+            {
+                codePoint = utf8.codePoint();
+                return true;
+            }
+        }
+
+        if (iter == first)
+            ++iter;
+        return false;
+    }
+
+    // Decodes the code point at `iter` and moves past it, malformed input is decoded as U+FFFD
+    inline char32_t nextCodePoint(const char*& iter, const char* last)
+    {
+        char32_t c;
+        return decodeSequence(iter, last, c) ? c : 0xFFFD;
+    }
+
+    template<typename CharT>
+    inline char32_t nextCodePoint(const CharT*& iter, const CharT* last)
+    {
+        static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4, "unsupported character size");
+
+        auto c = static_cast<char32_t>(*iter++);
+        if (sizeof(CharT) == 2 && c >= 0xD800 && c < 0xDC00 && iter != last)
+        {
+            auto trail = static_cast<char32_t>(*iter);
+            if (trail >= 0xDC00 && trail < 0xE000)
+            {
+                ++iter;
+                return utf16SurrogatePairToUtf32(c, trail);
+            }
+        }
+
+        return (c >= 0xD800 && c < 0xE000) || c > 0x10FFFF ? 0xFFFD : c;
+    }
+
+#if defined JSONCPP_INTERNAL_SSE2
+    // One bit per byte of the ASCII characters in the block, as `_mm_movemask_epi8` returns
+    template<std::size_t CharSize>
+    inline unsigned asciiMask(__m128i block);
+
+    template<>
+    inline unsigned asciiMask<1>(__m128i block)
+    {
+        return ~static_cast<unsigned>(_mm_movemask_epi8(block)) & 0xFFFF;
+    }
+
+    template<>
+    inline unsigned asciiMask<2>(__m128i block)
+    {
+        auto high = _mm_and_si128(block, _mm_set1_epi16(-0x80));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())));
+    }
+
+    template<>
+    inline unsigned asciiMask<4>(__m128i block)
+    {
+        auto high = _mm_and_si128(block, _mm_set1_epi32(-0x80));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())));
+    }
+#endif
+
+    // Returns the end of the run of ASCII characters, scans 16 bytes at a time with SSE2
+    template<typename CharT>
+    inline const CharT* findAsciiEnd(const CharT* iter, const CharT* last)
+    {
+#if defined JSONCPP_INTERNAL_SSE2
+        const auto perBlock = 16 / sizeof(CharT);
+        while (static_cast<std::size_t>(last - iter) >= perBlock)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iter));
+            auto stops = ~asciiMask<sizeof(CharT)>(block) & 0xFFFF;
+            if (stops != 0)
+                return iter + countTrailingZeros(stops) / sizeof(CharT);
+
+            iter += perBlock;
+        }
+#endif
+
+        while (iter != last && isAscii(*iter))
+            ++iter;
+        return iter;
+    }
+
+    // Appends ASCII characters to a UTF-16 or UTF-32 string, 16 at a time with SSE2
+    template<typename CharT, class Traits, class Alloc>
+    inline void widenAscii(const char* first, const char* last, std::basic_string<CharT, Traits, Alloc>& str)
+    {
+        static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4, "unsupported character size");
+
+        auto size = str.size();
+        str.resize(size + static_cast<std::size_t>(last - first));
+        auto out = &str[size];
+
+#if defined JSONCPP_INTERNAL_SSE2
+        const auto zero = _mm_setzero_si128();
+        for (; last - first >= 16; first += 16, out += 16)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            __m128i utf16[2] = {_mm_unpacklo_epi8(block, zero), _mm_unpackhi_epi8(block, zero)};
+            if (sizeof(CharT) == 2)
+            {
+                std::memcpy(out, utf16, sizeof(utf16));
+            }
+            else
+            {
+                __m128i utf32[4] = {_mm_unpacklo_epi16(utf16[0], zero), _mm_unpackhi_epi16(utf16[0], zero),
+                    _mm_unpacklo_epi16(utf16[1], zero), _mm_unpackhi_epi16(utf16[1], zero)};
+                std::memcpy(out, utf32, sizeof(utf32));
+            }
+        }
+#endif
+
+        for (; first != last; ++first, ++out)
+            *out = static_cast<CharT>(*first);
+    }
+
+    // Copies ASCII characters from a UTF-16 or UTF-32 string, 16 at a time with SSE2
+    template<typename CharT>
+    inline void narrowAscii(const CharT* first, const CharT* last, char* out)
+    {
+        static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4, "unsupported character size");
+
+#if defined JSONCPP_INTERNAL_SSE2
+        for (; last - first >= 16; first += 16, out += 16)
+        {
+            auto blocks = reinterpret_cast<const __m128i*>(first);
+            __m128i bytes;
+            if (sizeof(CharT) == 2)
+            {
+                bytes = _mm_packus_epi16(_mm_loadu_si128(blocks), _mm_loadu_si128(blocks + 1));
+            }
+            else
+            {
+                auto low = _mm_packs_epi32(_mm_loadu_si128(blocks), _mm_loadu_si128(blocks + 1));
+                auto high = _mm_packs_epi32(_mm_loadu_si128(blocks + 2), _mm_loadu_si128(blocks + 3));
+                bytes = _mm_packus_epi16(low, high);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        }
+#endif
+
+        for (; first != last; ++first, ++out)
+            *out = static_cast<char>(*first);
+    }
+
+    // Decodes UTF-8 into a wide string, invalid sequences are replaced with U+FFFD
+    template<typename CharT, class Traits, class Alloc>
+    inline void utf8ToWide(const char* first, const char* last, std::basic_string<CharT, Traits, Alloc>& str)
+    {
+        for (;;)
+        {
+            auto runEnd = findAsciiEnd(first, last);
+            widenAscii(first, runEnd, str);
+            first = runEnd;
+            if (first == last)
+                return;
+
+            addCodePoint(str, nextCodePoint(first, last));
+        }
+    }
+
+    // Encodes UTF-16 (2-byte characters) or UTF-32 (4-byte characters) into UTF-8,
+    // lone surrogates and other invalid code points are replaced with U+FFFD
+    template<typename CharT, class Traits, class Alloc>
+    inline void wideToUtf8(const std::basic_string<CharT, Traits, Alloc>& wide, std::string& str)
+    {
+        for (auto iter = wide.data(), last = iter + wide.size(); iter != last;)
+        {
+            auto runEnd = findAsciiEnd(iter, last);
+            auto size = str.size();
+            str.resize(size + static_cast<std::size_t>(runEnd - iter));
+            narrowAscii(iter, runEnd, &str[0] + size);
+            iter = runEnd;
+
+            if (iter != last)
+                utf32ToUtf8(nextCodePoint(iter, last), str);
+        }
+    }
+}}
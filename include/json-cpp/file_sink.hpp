@@ -0,0 +1,225 @@
+// JSON for C++ : generator sink writing to a POSIX file descriptor
+// Belongs to the public domain
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <json-cpp/generate.hpp>
+#include <json-cpp/details/number_writer.hpp>
+
+namespace jsoncpp
+{
+    // Buffered sink for `Generator` which bypasses iostreams.
+    // Writes go through one large buffer, chunks larger than half of the buffer
+    // are passed to `writev` together with the buffered data without copying.
+    // In the aligned mode the buffer is block-aligned and only whole blocks are written
+    // until `finish()`, which makes the sink usable with `O_DIRECT` file descriptors.
+    class FileSink
+    {
+    public:
+        enum Mode { Buffered, Aligned };
+
+        static const std::size_t DefaultBufferSize = 1 << 20;
+        static const std::size_t BlockSize = 4096;
+
+        explicit FileSink(int fd, std::size_t bufferSize = DefaultBufferSize, Mode mode = Buffered)
+            : m_fd{fd}, m_mode{mode}
+        {
+            auto alignment = mode == Aligned ? BlockSize : alignof(std::max_align_t);
+            // At least one block, an empty buffer would have no room for `put()`
+            m_capacity = (std::max<std::size_t>(bufferSize, 1) + BlockSize - 1) / BlockSize * BlockSize;
+
+            void* buffer = nullptr;
+            if (posix_memalign(&buffer, alignment, m_capacity) != 0)
+                throw std::bad_alloc();
+
+            m_buffer.reset(static_cast<char*>(buffer));
+        }
+
+        FileSink(const FileSink&) = delete;
+        void operator=(const FileSink&) = delete;
+
+        // Call `finish()` explicitly to get write errors reported
+        ~FileSink()
+        {
+            try
+            {
+                finish();
+            }
+            catch (const std::system_error&)
+            {
+            }
+        }
+
+        void put(char ch)
+        {
+            if (m_size == m_capacity)
+                flush();
+
+            m_buffer.get()[m_size++] = ch;
+        }
+
+        void write(const char* data, std::size_t size)
+        {
+            if (size <= m_capacity - m_size)
+            {
+                std::memcpy(m_buffer.get() + m_size, data, size);
+                m_size += size;
+                return;
+            }
+
+            if (m_mode == Buffered && size >= m_capacity / 2)
+            {
+                iovec vec[2] = {{m_buffer.get(), m_size}, {const_cast<char*>(data), size}};
+                writeAll(vec, 2);
+                m_size = 0;
+                return;
+            }
+
+            while (size != 0)
+            {
+                if (m_size == m_capacity)
+                    flush();
+
+                auto chunk = std::min(size, m_capacity - m_size);
+                std::memcpy(m_buffer.get() + m_size, data, chunk);
+                m_size += chunk;
+                data += chunk;
+                size -= chunk;
+            }
+        }
+
+        FileSink& operator<<(char ch) { put(ch); return *this; }
+        FileSink& operator<<(signed char ch) { put(static_cast<char>(ch)); return *this; }
+        FileSink& operator<<(unsigned char ch) { put(static_cast<char>(ch)); return *this; }
+        FileSink& operator<<(const char* str) { write(str, std::strlen(str)); return *this; }
+        FileSink& operator<<(const std::string& str) { write(str.data(), str.size()); return *this; }
+
+        template<typename T>
+        typename std::enable_if<std::is_arithmetic<T>::value, FileSink&>::type operator<<(T value)
+        {
+            char buf[details::MaxNumberLength];
+            write(buf, details::formatNumber(buf, value));
+            return *this;
+        }
+
+        // Writes the buffered data, in the aligned mode an incomplete last block stays in the buffer
+        void flush()
+        {
+            auto size = m_mode == Aligned ? m_size / BlockSize * BlockSize : m_size;
+            if (size == 0)
+                return;
+
+            iovec vec = {m_buffer.get(), size};
+            writeAll(&vec, 1);
+
+            m_size -= size;
+            std::memmove(m_buffer.get(), m_buffer.get() + size, m_size);
+        }
+
+        // Writes all buffered data, including an incomplete last block in the aligned mode
+        void finish()
+        {
+            flush();
+            if (m_size == 0)
+                return;
+
+            // The incomplete block can't be written with O_DIRECT, the flag of the caller's fd is restored afterwards
+            auto flags = -1;
+#if defined O_DIRECT
+            flags = fcntl(m_fd, F_GETFL);
+            if (flags == -1 || (flags & O_DIRECT) == 0 || fcntl(m_fd, F_SETFL, flags & ~O_DIRECT) == -1)
+                flags = -1;
+#endif
+
+            try
+            {
+                iovec vec = {m_buffer.get(), m_size};
+                writeAll(&vec, 1);
+                m_size = 0;
+            }
+            catch (...)
+            {
+                restoreFlags(flags);
+                throw;
+            }
+
+            restoreFlags(flags);
+        }
+
+    private:
+        struct FreeDeleter
+        {
+            void operator()(char* ptr) const { std::free(ptr); }
+        };
+
+        void restoreFlags(int flags)
+        {
+            if (flags != -1)
+                fcntl(m_fd, F_SETFL, flags);
+        }
+
+        void writeAll(iovec* vec, int count)
+        {
+            while (count != 0)
+            {
+                auto written = ::writev(m_fd, vec, count);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    throw std::system_error(errno, std::generic_category(), "writev");
+                }
+
+                auto rest = static_cast<std::size_t>(written);
+                for (; count != 0 && rest >= vec->iov_len; ++vec, --count)
+                    rest -= vec->iov_len;
+
+                if (count != 0)
+                {
+                    vec->iov_base = static_cast<char*>(vec->iov_base) + rest;
+                    vec->iov_len -= rest;
+                }
+            }
+        }
+
+        int m_fd;
+        Mode m_mode;
+        std::unique_ptr<char, FreeDeleter> m_buffer;
+        std::size_t m_capacity;
+        std::size_t m_size{0};
+    };
+
+    namespace details
+    {
+        template<>
+        struct NumberFormat<FileSink>
+        {
+            static bool isDefault(const FileSink&) { return true; }
+        };
+    }
+
+    template<class T>
+    inline void to_fd(const T& object, int fd)
+    {
+        FileSink sink{fd};
+        Generator<details::Traits2<char, FileSink>> stream{sink};
+        serialize(stream, const_cast<T&>(object));
+        sink.finish();
+    }
+}
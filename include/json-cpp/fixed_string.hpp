@@ -0,0 +1,154 @@
+// JSON for C++ : fixed-capacity strings
+// Belongs to the public domain
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <json-cpp/parse.hpp>
+#include <json-cpp/generate.hpp>
+#include <json-cpp/string_ref.hpp>
+
+namespace jsoncpp
+{
+    // A string of up to `N` characters stored inline, it never allocates.
+    // Growing past the capacity throws `std::length_error`, the parser reports it as `StringIsTooLong`.
+    template<std::size_t N>
+    class FixedString
+    {
+    public:
+        using value_type = char;
+        using size_type = std::size_t;
+
+        FixedString() { m_data[0] = 0; }
+
+        FixedString(const char* str) { assign(str, std::strlen(str)); }
+
+        FixedString(const char* str, std::size_t size) { assign(str, size); }
+
+        const char* data() const { return m_data; }
+        const char* c_str() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        static std::size_t capacity() { return N; }
+
+        char& operator[](std::size_t i) { return m_data[i]; }
+        const char& operator[](std::size_t i) const { return m_data[i]; }
+
+        const char* begin() const { return m_data; }
+        const char* end() const { return m_data + m_size; }
+
+        void clear() { resize(0); }
+
+        void resize(std::size_t size)
+        {
+            checkSize(size);
+            if (size > m_size)
+                std::fill(m_data + m_size, m_data + size, '\0');
+            m_size = size;
+            m_data[size] = 0;
+        }
+
+        void push_back(char ch)
+        {
+            checkSize(m_size + 1);
+            m_data[m_size++] = ch;
+            m_data[m_size] = 0;
+        }
+
+        void append(const char* str, std::size_t size)
+        {
+            checkSize(m_size + size);
+            std::copy(str, str + size, m_data + m_size);
+            m_size += size;
+            m_data[m_size] = 0;
+        }
+
+        void append(const char* first, const char* last)
+        {
+            append(first, static_cast<std::size_t>(last - first));
+        }
+
+        void assign(const char* str, std::size_t size)
+        {
+            m_size = 0;
+            append(str, size);
+        }
+
+        std::string str() const { return{m_data, m_size}; }
+
+        friend bool operator==(const FixedString& lhs, const FixedString& rhs)
+        {
+            return lhs.m_size == rhs.m_size && std::equal(lhs.m_data, lhs.m_data + lhs.m_size, rhs.m_data);
+        }
+
+        friend bool operator!=(const FixedString& lhs, const FixedString& rhs) { return !(lhs == rhs); }
+
+        friend bool operator==(const FixedString& lhs, const char* rhs)
+        {
+            return std::strlen(rhs) == lhs.m_size && std::equal(lhs.m_data, lhs.m_data + lhs.m_size, rhs);
+        }
+
+        friend bool operator!=(const FixedString& lhs, const char* rhs) { return !(lhs == rhs); }
+
+        friend bool operator<(const FixedString& lhs, const FixedString& rhs)
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+    private:
+        static void checkSize(std::size_t size)
+        {
+            if (size > N)
+                throw std::length_error("jsoncpp::FixedString: capacity exceeded");
+        }
+
+        std::size_t m_size{0};
+        char m_data[N + 1];
+    };
+
+    namespace details
+    {
+        // Other parsers have no generic string parsing, the string goes through `std::string`
+        template<class X, std::size_t N>
+        inline void parseFixedString(Parser<X>& parser, FixedString<N>& value)
+        {
+            std::string str;
+            serialize(parser, str);
+            if (str.size() > N)
+                throw parser.makeError(ParserError::StringIsTooLong);
+            value.assign(str.data(), str.size());
+        }
+
+        template<typename CharT, typename Iterator, class StatsPolicy, std::size_t N>
+        inline void parseFixedString(Parser<Traits2<CharT, Iterator, StatsPolicy>>& parser, FixedString<N>& value)
+        {
+            parser.checkType(Type::String);
+            try
+            {
+                parser.parseString(value);
+            }
+            catch (const std::length_error&)
+            {
+                throw parser.makeError(ParserError::StringIsTooLong);
+            }
+        }
+    }
+
+    template<class X, std::size_t N>
+    inline void serialize(Parser<X>& parser, FixedString<N>& value)
+    {
+        details::parseFixedString(parser, value);
+    }
+
+    template<class X, std::size_t N>
+    inline void serialize(Generator<X>& generator, FixedString<N>& value)
+    {
+        StringRef str{value.data(), value.size()};
+        serialize(generator, str);
+    }
+}
@@ -3,38 +3,69 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstring>
 #include <sstream>
 #include <string>
 
 #include <json-cpp/Stream.hpp>
+#include <json-cpp/string_ref.hpp>
+#include <json-cpp/value_types.hpp>
+#include <json-cpp/details/no_stats.hpp>
+#include <json-cpp/details/number_writer.hpp>
 #include <json-cpp/details/string_writer.hpp>
 
 namespace jsoncpp
 {
-    template<typename CharT, typename Sink>
-    class Stream<details::GeneratorTraits<details::Traits2<CharT, Sink>>>
+    struct GeneratorOptions
+    {
+        // Write non-ASCII characters as `\u` escapes, so the output is pure ASCII
+        bool escapeNonAscii{false};
+    };
+
+    template<typename CharT, typename Sink, class StatsPolicy>
+    class Stream<details::GeneratorTraits<details::Traits2<CharT, Sink, StatsPolicy>>>
     {
     public:
-        using this_type = Generator<details::Traits2<CharT, Sink>>;
+        using this_type = Generator<details::Traits2<CharT, Sink, StatsPolicy>>;
+
+        explicit Stream(Sink& sink, StatsPolicy stats = StatsPolicy{}) : m_sink(&sink), m_stats(stats) {}
+
+        Stream(Sink& sink, const GeneratorOptions& options, StatsPolicy stats = StatsPolicy{})
+            : m_sink(&sink), m_options(options), m_stats(stats) {}
 
-        explicit Stream(Sink& sink) : m_sink(&sink) {}
+        const GeneratorOptions& options() const { return m_options; }
+        StatsPolicy& stats() { return m_stats; }
+
+        // True if the sink formats numbers like `formatNumber`, see `details::NumberFormat`
+        bool hasDefaultNumberFormat() const { return details::NumberFormat<Sink>::isDefault(*m_sink); }
 
         void objectBegin()
         {
+            m_stats.value(Type::Object);
             (*m_sink) << "{";
         }
 
         void fieldName(const char* name)
         {
-            (*m_sink) << '"' << name << "\": ";
-            // TODO: use writeString (?)
+            m_stats.writtenString(name);
+            writeString(name, std::strlen(name));
+            (*m_sink) << ": ";
+        }
+
+        template<typename StrCharT, class Traits, class Alloc>
+        void fieldName(const std::basic_string<StrCharT, Traits, Alloc>& name)
+        {
+            m_stats.writtenString(name);
+            writeString(name.data(), name.size());
+            (*m_sink) << ": ";
         }
 
-        template<typename StrCharT>
-        void fieldName(const std::basic_string<StrCharT>& name)
+        void fieldName(const StringRef& name)
         {
-            (*m_sink) << '"' << name << "\": ";
-            // TODO: use writeString (?)
+            m_stats.writtenString(name);
+            writeString(name.data, name.size);
+            (*m_sink) << ": ";
         }
 
         void separator()
@@ -44,43 +75,97 @@ namespace jsoncpp
 
         void objectEnd()
         {
+            m_stats.listEnd();
             (*m_sink) << '}';
         }
 
         void arrayBegin()
         {
+            m_stats.value(Type::Array);
             (*m_sink) << '[';
         }
 
         void arrayEnd()
         {
+            m_stats.listEnd();
             (*m_sink) << ']';
         }
 
+        // Writes an array of numbers, it's the same as writing the items one by one,
+        // but if the sink formats numbers like `formatNumber` they are formatted in batches
+        template<typename T>
+        void writeNumberArray(T* numbers, std::size_t size)
+        {
+            arrayBegin();
+            if (hasDefaultNumberFormat())
+            {
+                for (std::size_t i = 0; i != size; ++i)
+                    m_stats.value(Type::Number);
+                details::writeNumbers(numbers, size, [this](const char* data, std::size_t count) { m_sink->write(data, count); });
+            }
+            else
+            {
+                for (std::size_t i = 0; i != size; ++i)
+                {
+                    if (i != 0)
+                        separator();
+                    serialize(*this, numbers[i]);
+                }
+            }
+            arrayEnd();
+        }
+
+        // Writes already generated JSON text as is
+        void writeRaw(const char* data, std::size_t size)
+        {
+            m_sink->write(data, size);
+        }
+
         friend void serialize(this_type& stream, std::nullptr_t)
         {
+            stream.m_stats.value(Type::Null);
             (*stream.m_sink) << "null";
         }
 
         friend void serialize(this_type& stream, bool value)
         {
+            stream.m_stats.value(Type::Boolean);
             (*stream.m_sink) << (value ? "true" : "false");
         }
 
         template<typename T>
         friend typename std::enable_if<std::is_arithmetic<T>::value>::type serialize(this_type& stream, T& value)
         {
+            stream.m_stats.value(Type::Number);
             (*stream.m_sink) << value;
         }
 
-        template<typename SrcCharT>
-        friend void serialize(this_type& stream, const std::basic_string<SrcCharT>& value)
+        template<typename SrcCharT, class Traits, class Alloc>
+        friend void serialize(this_type& stream, const std::basic_string<SrcCharT, Traits, Alloc>& value)
         {
-            details::writeString(value, [&stream](char c){ stream.m_sink->put(c); });
+            stream.m_stats.value(Type::String);
+            stream.m_stats.writtenString(value);
+            stream.writeString(value.data(), value.size());
+        }
+
+        friend void serialize(this_type& stream, StringRef& value)
+        {
+            stream.m_stats.value(Type::String);
+            stream.m_stats.writtenString(value);
+            stream.writeString(value.data, value.size);
         }
 
     private:
+        template<typename SrcCharT>
+        void writeString(const SrcCharT* str, std::size_t size)
+        {
+            details::writeString(str, size, [this](const char* data, std::size_t count) { m_sink->write(data, count); },
+                m_options.escapeNonAscii);
+        }
+
         Sink* m_sink;
+        GeneratorOptions m_options;
+        StatsPolicy m_stats;
     };
 
     template<class X, typename Pointer>
@@ -128,4 +213,13 @@ namespace jsoncpp
         serialize(stream, const_cast<T&>(object));
         return rawStream.str();
     }
+
+    template<class T>
+    inline std::string to_string(const T& object, const GeneratorOptions& options)
+    {
+        std::ostringstream rawStream;
+        Generator<details::Traits2<char, std::ostream>> stream{rawStream, options};
+        serialize(stream, const_cast<T&>(object));
+        return rawStream.str();
+    }
 }
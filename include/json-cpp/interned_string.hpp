@@ -0,0 +1,169 @@
+// JSON for C++ : interned strings
+// Belongs to the public domain
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include <json-cpp/parse.hpp>
+#include <json-cpp/generate.hpp>
+#include <json-cpp/string_ref.hpp>
+
+namespace jsoncpp
+{
+    // A set of distinct strings shared by threads, strings are never removed, so the pool must outlive
+    // the strings interned in it. It's split into shards with their own locks, which are picked by the hash.
+    class StringPool
+    {
+    public:
+        StringPool() = default;
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        // The pool which the parser uses
+        static StringPool& global()
+        {
+            static StringPool pool;
+            return pool;
+        }
+
+        // Returns the pooled copy of the string, it allocates only for strings which aren't in the pool yet
+        const std::string* intern(const char* data, std::size_t size)
+        {
+            auto hash = hashBytes(data, size);
+            auto& shard = m_shards[hash % ShardCount];
+
+            std::lock_guard<std::mutex> lock{shard.mutex};
+            auto iter = shard.index.find(Key{data, size, hash, nullptr});
+            if (iter != shard.index.end())
+                return iter->str;
+
+            // Elements of a deque don't move when it grows
+            shard.strings.emplace_back(data, size);
+            auto str = &shard.strings.back();
+            shard.index.insert(Key{str->data(), str->size(), hash, str});
+            return str;
+        }
+
+        std::size_t size()
+        {
+            std::size_t count = 0;
+            for (auto& shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock{shard.mutex};
+                count += shard.strings.size();
+            }
+            return count;
+        }
+
+    private:
+        static const std::size_t ShardCount = 16;
+
+        // FNV-1a, there's no `std::hash` for a span of characters in C++11
+        static std::size_t hashBytes(const char* data, std::size_t size)
+        {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+            return static_cast<std::size_t>(hash ^ (hash >> 32));
+        }
+
+        // Lookups use the parsed characters as a key, so a hit doesn't copy them
+        struct Key
+        {
+            const char* data;
+            std::size_t size;
+            std::size_t hash;
+            const std::string* str;
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const { return key.hash / ShardCount; }
+        };
+
+        struct KeyEqual
+        {
+            bool operator()(const Key& lhs, const Key& rhs) const
+            {
+                return lhs.size == rhs.size && std::equal(lhs.data, lhs.data + lhs.size, rhs.data);
+            }
+        };
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::deque<std::string> strings;
+            std::unordered_set<Key, KeyHash, KeyEqual> index;
+        };
+
+        Shard m_shards[ShardCount];
+    };
+
+    // A handle to a string in a `StringPool`, it's one pointer, and equal strings of one pool share the characters.
+    // It's meant for values which repeat a lot, like status codes or event types.
+    class InternedString
+    {
+    public:
+        InternedString() = default;
+
+        InternedString(const char* str, StringPool& pool = StringPool::global())
+            : m_str(pool.intern(str, std::strlen(str))) {}
+
+        InternedString(const char* data, std::size_t size, StringPool& pool = StringPool::global())
+            : m_str(pool.intern(data, size)) {}
+
+        InternedString(const std::string& str, StringPool& pool = StringPool::global())
+            : m_str(pool.intern(str.data(), str.size())) {}
+
+        const std::string& str() const { return m_str ? *m_str : empty(); }
+        const char* data() const { return str().data(); }
+        const char* c_str() const { return str().c_str(); }
+        std::size_t size() const { return str().size(); }
+
+        // Strings of one pool are equal if they are the same string
+        friend bool operator==(const InternedString& lhs, const InternedString& rhs)
+        {
+            return lhs.m_str == rhs.m_str || lhs.str() == rhs.str();
+        }
+
+        friend bool operator!=(const InternedString& lhs, const InternedString& rhs) { return !(lhs == rhs); }
+
+        friend bool operator<(const InternedString& lhs, const InternedString& rhs) { return lhs.str() < rhs.str(); }
+
+    private:
+        static const std::string& empty()
+        {
+            static const std::string str;
+            return str;
+        }
+
+        const std::string* m_str{nullptr};
+    };
+
+    // The characters are decoded into a buffer of the thread, so a string which is in the pool doesn't allocate
+    template<class X>
+    inline void serialize(Parser<X>& parser, InternedString& value)
+    {
+        static thread_local std::string buffer;
+        serialize(parser, buffer);
+        value = InternedString{buffer.data(), buffer.size()};
+    }
+
+    template<class X>
+    inline void serialize(Generator<X>& generator, InternedString& value)
+    {
+        StringRef str{value.data(), value.size()};
+        serialize(generator, str);
+    }
+}
@@ -0,0 +1,521 @@
+// JSON for C++ : MessagePack parser and generator
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <json-cpp/ParserError.hpp>
+#include <json-cpp/Stream.hpp>
+#include <json-cpp/value_types.hpp>
+#include <json-cpp/parse.hpp>
+#include <json-cpp/generate.hpp>
+#include <json-cpp/string_ref.hpp>
+#include <json-cpp/details/parser_utility.hpp>
+#include <json-cpp/details/string_parser.hpp>
+
+namespace jsoncpp
+{
+    namespace details
+    {
+        // MessagePack counterpart of Traits2.
+        // The parser works on contiguous memory only (`const char*`),
+        // the generator writes to a `std::string`, because container headers are patched in place.
+        template<typename T>
+        struct MsgPackTraits {};
+    }
+
+    template<>
+    class Stream<details::ParserTraits<details::MsgPackTraits<const char*>>>
+    {
+    public:
+        using this_type = Parser<details::MsgPackTraits<const char*>>;
+
+        explicit Stream(const char* first, const char* last)
+            : m_begin{first}, m_pos{first}, m_end{last}
+        {
+            nextValue();
+        }
+
+        Type getType() const { return m_type; }
+        bool getBoolean() const { return m_boolean; }
+        double getNumber() const { return m_number; }
+        float getFloat() const { return static_cast<float>(m_number); }
+
+        // Integers are kept exactly, 64-bit values don't fit in a double
+        bool getInteger(details::IntegerNumber& number) const
+        {
+            if (!m_isInteger)
+                return details::doubleToInteger(m_number, number);
+
+            number = m_integer;
+            return true;
+        }
+        const std::string& getFieldName() const { return m_fieldName; }
+        StringRef getStringRef() const { return m_string; }
+
+        const details::FieldMask* getFieldMask() const { return m_fieldMask; }
+        void setFieldMask(const details::FieldMask* mask) { m_fieldMask = mask; }
+
+        void checkType(Type type) const
+        {
+            if (getType() != type)
+                throw makeError(ParserError::UnexpectedType);
+        }
+
+        // Lists are prefixed with the item count, it's checked against the input size
+        std::size_t listSizeHint() const
+        {
+            if (m_type != Type::Array && m_type != Type::Object)
+                return 0;
+
+            auto size = m_type == Type::Object ? m_lists.back() / 2 : m_lists.back();
+            auto available = static_cast<std::uint64_t>(m_end - m_pos);
+            return static_cast<std::size_t>(size < available ? size : available);
+        }
+
+        // The terminator is ignored, MessagePack lists are counted
+        bool isListEnd(char /*terminator*/)
+        {
+            if (m_lists.back() != 0)
+                return false;
+
+            m_lists.pop_back();
+            return true;
+        }
+
+        void eatListSeparator() {}
+
+        void nextNameValuePair()
+        {
+            consumeListItem();
+            readItem();
+            checkType(Type::String);
+            m_fieldName.assign(m_string.data, m_string.size);
+
+            consumeListItem();
+            readItem();
+        }
+
+        void nextValue()
+        {
+            consumeListItem();
+            readItem();
+        }
+
+        template<class Traits, class Alloc>
+        void parseString(std::basic_string<char, Traits, Alloc>& str)
+        {
+            str.assign(m_string.data, m_string.size);
+        }
+
+        template<typename DstCharT, class Traits, class Alloc>
+        void parseString(std::basic_string<DstCharT, Traits, Alloc>& str)
+        {
+            str.clear();
+            details::utf8ToWide(m_string.data, m_string.data + m_string.size, str);
+        }
+
+        ParserError makeError(ParserError::Type type) const
+        {
+            return{type, 1, static_cast<std::size_t>(m_pos - m_begin)};
+        }
+
+        void skipValue()
+        {
+            if (m_type == Type::Array || m_type == Type::Object)
+                skipListRest();
+        }
+
+        void skipListRest()
+        {
+            while (!isListEnd(0))
+            {
+                nextValue();
+                skipValue();
+            }
+        }
+
+    private:
+        void consumeListItem()
+        {
+            if (!m_lists.empty())
+                --m_lists.back();
+        }
+
+        const char* advance(std::size_t size)
+        {
+            if (static_cast<std::size_t>(m_end - m_pos) < size)
+                throw makeError(ParserError::Eof);
+
+            auto pos = m_pos;
+            m_pos += size;
+            return pos;
+        }
+
+        std::uint64_t readBigEndian(std::size_t size)
+        {
+            auto pos = advance(size);
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i != size; ++i)
+                value = value << 8 | static_cast<std::uint8_t>(pos[i]);
+            return value;
+        }
+
+        // Sign extension in unsigned arithmetic, the two's complement value is split into the sign and the magnitude
+        void readSigned(std::size_t size)
+        {
+            auto value = readBigEndian(size);
+            auto signBit = std::uint64_t{1} << (size * 8 - 1);
+            value = (value ^ signBit) - signBit;
+
+            auto negative = (value >> 63) != 0;
+            setInteger(negative, negative ? 0 - value : value);
+        }
+
+        void setNumber(double number)
+        {
+            m_number = number;
+            m_isInteger = false;
+            m_type = Type::Number;
+        }
+
+        void setInteger(bool negative, std::uint64_t magnitude)
+        {
+            m_integer = details::IntegerNumber{negative, magnitude};
+            m_number = negative ? -static_cast<double>(magnitude) : static_cast<double>(magnitude);
+            m_isInteger = true;
+            m_type = Type::Number;
+        }
+
+        void setString(std::size_t size)
+        {
+            m_string = StringRef{advance(size), size};
+            m_type = Type::String;
+        }
+
+        void setList(Type type, std::size_t size)
+        {
+            m_lists.push_back(type == Type::Object ? size * 2 : size);
+            m_type = type;
+        }
+
+        void readItem()
+        {
+            auto initial = static_cast<std::uint8_t>(*advance(1));
+            if (initial < 0x80) return setInteger(false, initial);
+            if (initial < 0x90) return setList(Type::Object, initial & 0x0F);
+            if (initial < 0xA0) return setList(Type::Array, initial & 0x0F);
+            if (initial < 0xC0) return setString(initial & 0x1F);
+            if (initial >= 0xE0) return setInteger(true, 0x100 - initial);
+
+            switch (initial)
+            {
+            case 0xC0: m_type = Type::Null; return;
+            case 0xC2: m_boolean = false; m_type = Type::Boolean; return;
+            case 0xC3: m_boolean = true; m_type = Type::Boolean; return;
+
+            case 0xC4: case 0xD9: return setString(readBigEndian(1));
+            case 0xC5: case 0xDA: return setString(readBigEndian(2));
+            case 0xC6: case 0xDB: return setString(readBigEndian(4));
+
+            case 0xCA:
+                {
+                    auto bits = static_cast<std::uint32_t>(readBigEndian(4));
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return setNumber(value);
+                }
+
+            case 0xCB:
+                {
+                    auto bits = readBigEndian(8);
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return setNumber(value);
+                }
+
+            case 0xCC: return setInteger(false, readBigEndian(1));
+            case 0xCD: return setInteger(false, readBigEndian(2));
+            case 0xCE: return setInteger(false, readBigEndian(4));
+            case 0xCF: return setInteger(false, readBigEndian(8));
+            case 0xD0: return readSigned(1);
+            case 0xD1: return readSigned(2);
+            case 0xD2: return readSigned(4);
+            case 0xD3: return readSigned(8);
+
+            case 0xDC: return setList(Type::Array, readBigEndian(2));
+            case 0xDD: return setList(Type::Array, readBigEndian(4));
+            case 0xDE: return setList(Type::Object, readBigEndian(2));
+            case 0xDF: return setList(Type::Object, readBigEndian(4));
+            }
+
+            throw makeError(ParserError::UnexpectedType);
+        }
+
+        const char* m_begin;
+        const char* m_pos;
+        const char* m_end;
+
+        Type m_type;
+        double m_number;
+        details::IntegerNumber m_integer;
+        bool m_isInteger{false};
+        bool m_boolean;
+        StringRef m_string;
+        std::string m_fieldName;
+        const details::FieldMask* m_fieldMask{nullptr};
+
+        // Number of items left in each open list, a map item is either a key or a value
+        std::vector<std::uint64_t> m_lists;
+    };
+
+    template<>
+    class Stream<details::GeneratorTraits<details::MsgPackTraits<std::string>>>
+    {
+    public:
+        using this_type = Generator<details::MsgPackTraits<std::string>>;
+
+        explicit Stream(std::string& sink) : m_sink(&sink) {}
+
+        void objectBegin() { listBegin(true); }
+        void objectEnd() { listEnd(0x80, 0xDE); }
+        void arrayBegin() { listBegin(false); }
+        void arrayEnd() { listEnd(0x90, 0xDC); }
+        void separator() {}
+
+        void fieldName(const char* name)
+        {
+            ++m_lists.back().size;
+            writeString(name, std::strlen(name));
+        }
+
+        template<typename StrCharT, class Traits, class Alloc>
+        void fieldName(const std::basic_string<StrCharT, Traits, Alloc>& name)
+        {
+            ++m_lists.back().size;
+            writeString(name);
+        }
+
+        void fieldName(const StringRef& name)
+        {
+            ++m_lists.back().size;
+            writeString(name.data, name.size);
+        }
+
+        friend void serialize(this_type& stream, std::nullptr_t)
+        {
+            stream.beginItem();
+            stream.writeByte(0xC0);
+        }
+
+        friend void serialize(this_type& stream, bool value)
+        {
+            stream.beginItem();
+            stream.writeByte(value ? 0xC3 : 0xC2);
+        }
+
+        template<typename T>
+        friend typename std::enable_if<std::is_arithmetic<T>::value>::type serialize(this_type& stream, T& value)
+        {
+            stream.beginItem();
+            stream.writeNumber(value);
+        }
+
+        template<typename SrcCharT, class Traits, class Alloc>
+        friend void serialize(this_type& stream, const std::basic_string<SrcCharT, Traits, Alloc>& value)
+        {
+            stream.beginItem();
+            stream.writeString(value);
+        }
+
+        friend void serialize(this_type& stream, StringRef& value)
+        {
+            stream.beginItem();
+            stream.writeString(value.data, value.size);
+        }
+
+    private:
+        struct List
+        {
+            std::size_t offset;
+            std::size_t size;
+            bool isObject;
+        };
+
+        // Placeholder for the longest (32-bit) list header
+        static const std::size_t MaxListHeader = 5;
+
+        void beginItem()
+        {
+            if (!m_lists.empty() && !m_lists.back().isObject)
+                ++m_lists.back().size;
+        }
+
+        void writeByte(int byte)
+        {
+            m_sink->push_back(static_cast<char>(byte));
+        }
+
+        void writeBigEndian(int initial, std::uint64_t value, std::size_t size)
+        {
+            writeByte(initial);
+            for (auto i = size; i != 0; --i)
+                writeByte(static_cast<int>((value >> (i * 8 - 8)) & 0xFF));
+        }
+
+        void listBegin(bool isObject)
+        {
+            beginItem();
+            m_lists.push_back(List{m_sink->size(), 0, isObject});
+            m_sink->append(MaxListHeader, '\0');
+        }
+
+        // Writes the final list header and removes the unused part of the placeholder
+        void listEnd(int fixInitial, int initial16)
+        {
+            auto list = m_lists.back();
+            m_lists.pop_back();
+
+            char header[MaxListHeader];
+            std::size_t headerSize;
+            if (list.size < 16)
+            {
+                header[0] = static_cast<char>(fixInitial | static_cast<int>(list.size));
+                headerSize = 1;
+            }
+            else
+            {
+                headerSize = list.size <= 0xFFFF ? 3 : 5;
+                header[0] = static_cast<char>(headerSize == 3 ? initial16 : initial16 + 1);
+                for (std::size_t i = 1; i != headerSize; ++i)
+                    header[i] = static_cast<char>((list.size >> ((headerSize - 1 - i) * 8)) & 0xFF);
+            }
+
+            m_sink->erase(list.offset, MaxListHeader - headerSize);
+            std::memcpy(&(*m_sink)[list.offset], header, headerSize);
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type writeNumber(T value)
+        {
+            if (value >= 0)
+                writeUnsigned(static_cast<std::uint64_t>(value));
+            else if (value >= -32)
+                writeByte(static_cast<int>(value) & 0xFF);
+            else if (value >= INT8_MIN)
+                writeBigEndian(0xD0, static_cast<std::uint64_t>(value), 1);
+            else if (value >= INT16_MIN)
+                writeBigEndian(0xD1, static_cast<std::uint64_t>(value), 2);
+            else if (value >= INT32_MIN)
+                writeBigEndian(0xD2, static_cast<std::uint64_t>(value), 4);
+            else
+                writeBigEndian(0xD3, static_cast<std::uint64_t>(value), 8);
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_unsigned<T>::value>::type writeNumber(T value)
+        {
+            writeUnsigned(value);
+        }
+
+        void writeUnsigned(std::uint64_t value)
+        {
+            if (value < 0x80)
+                writeByte(static_cast<int>(value));
+            else if (value <= 0xFF)
+                writeBigEndian(0xCC, value, 1);
+            else if (value <= 0xFFFF)
+                writeBigEndian(0xCD, value, 2);
+            else if (value <= 0xFFFFFFFF)
+                writeBigEndian(0xCE, value, 4);
+            else
+                writeBigEndian(0xCF, value, 8);
+        }
+
+        void writeNumber(float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeBigEndian(0xCA, bits, 4);
+        }
+
+        void writeNumber(double value)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeBigEndian(0xCB, bits, 8);
+        }
+
+        void writeNumber(long double value)
+        {
+            writeNumber(static_cast<double>(value));
+        }
+
+        void writeString(const char* str, std::size_t size)
+        {
+            if (size < 32)
+                writeByte(0xA0 | static_cast<int>(size));
+            else if (size <= 0xFF)
+                writeBigEndian(0xD9, size, 1);
+            else if (size <= 0xFFFF)
+                writeBigEndian(0xDA, size, 2);
+            else
+                writeBigEndian(0xDB, size, 4);
+
+            m_sink->append(str, size);
+        }
+
+        template<class Traits, class Alloc>
+        void writeString(const std::basic_string<char, Traits, Alloc>& str)
+        {
+            writeString(str.data(), str.size());
+        }
+
+        template<typename SrcCharT, class Traits, class Alloc>
+        void writeString(const std::basic_string<SrcCharT, Traits, Alloc>& str)
+        {
+            std::string utf8;
+            details::wideToUtf8(str, utf8);
+            writeString(utf8);
+        }
+
+        std::string* m_sink;
+        std::vector<List> m_lists;
+    };
+
+    template<class X>
+    inline void serialize(Parser<X>& parser, StringRef& value)
+    {
+        parser.checkType(Type::String);
+        value = parser.getStringRef();
+    }
+
+    template<class T>
+    inline std::string to_msgpack(const T& object)
+    {
+        std::string result;
+        Generator<details::MsgPackTraits<std::string>> stream{result};
+        serialize(stream, const_cast<T&>(object));
+        return result;
+    }
+
+    // Strings parsed into `StringRef` point into the buffer, so it must outlive them
+    template<class T>
+    inline void parse_msgpack(T& object, const char* first, const char* last)
+    {
+        Parser<details::MsgPackTraits<const char*>> stream{first, last};
+        serialize(stream, object);
+    }
+
+    template<class T>
+    inline void parse_msgpack(T& object, const std::string& data)
+    {
+        parse_msgpack(object, data.data(), data.data() + data.size());
+    }
+}
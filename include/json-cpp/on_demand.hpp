@@ -0,0 +1,295 @@
+// JSON for C++ : on-demand (lazy) document access
+// Belongs to the public domain
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <string>
+
+#include <json-cpp/parse.hpp>
+
+namespace jsoncpp
+{
+    template<class X>
+    class OnDemandDocument;
+
+    // A forward-only cursor to a value of an OnDemandDocument.
+    // The value is parsed only as far as it is accessed, untouched parts are skipped.
+    // A value becomes invalid as soon as any of its siblings or ancestors is advanced.
+    template<class X>
+    class OnDemandValue
+    {
+    public:
+        class iterator;
+
+        OnDemandValue() : m_doc{nullptr}, m_depth{0}, m_type{Type::Undefined} {}
+
+        Type getType() const { return m_type; }
+
+        bool getBoolean()
+        {
+            checkType(Type::Boolean);
+            return m_doc->m_parser.getBoolean();
+        }
+
+        double getNumber()
+        {
+            checkType(Type::Number);
+            return m_doc->m_parser.getNumber();
+        }
+
+        template<typename CharT>
+        void getString(std::basic_string<CharT>& str)
+        {
+            checkType(Type::String);
+            assert(m_doc->m_pending && "the string has already been consumed");
+            m_doc->m_parser.parseString(str);
+            m_doc->m_pending = false;
+        }
+
+        std::string getString()
+        {
+            std::string str;
+            getString(str);
+            return str;
+        }
+
+        // Deserializes the whole value with the regular `serialize()` functions
+        template<typename T>
+        void get(T& object)
+        {
+            assert(!m_started && "the value has already been partially consumed");
+            serialize(m_doc->m_parser, object);
+            m_doc->m_depth = m_depth;
+            m_doc->m_pending = false;
+            m_finished = true;
+        }
+
+        void skip()
+        {
+            m_doc->skipTo(m_depth);
+            m_finished = true;
+        }
+
+        // Advances to the next element of an array or an object.
+        // For objects, `fieldName()` returns the name of the element's field.
+        bool next(OnDemandValue& element)
+        {
+            if (m_type != Type::Array && m_type != Type::Object)
+                throw makeError(ParserError::UnexpectedType);
+
+            if (m_finished)
+                return false;
+
+            m_doc->skipTo(m_depth + 1);
+
+            auto& parser = m_doc->m_parser;
+            auto terminator = m_type == Type::Object ? '}' : ']';
+            if (m_started)
+            {
+                if (parser.isListEnd(terminator))
+                    return finish();
+
+                parser.eatListSeparator();
+            }
+
+            m_started = true;
+            if (parser.isListEnd(terminator))
+                return finish();
+
+            if (m_type == Type::Object)
+                parser.nextNameValuePair();
+            else
+                parser.nextValue();
+
+            m_doc->onValue();
+            element = OnDemandValue{*m_doc, m_depth + 1};
+            return true;
+        }
+
+        const std::string& fieldName() const { return m_doc->m_parser.getFieldName(); }
+
+        // Scans forward for a field, skipping all fields before it.
+        // Fields must be looked up in the order they appear in the document.
+        bool findField(const std::string& name, OnDemandValue& value)
+        {
+            checkType(Type::Object);
+            while (next(value))
+            {
+                if (fieldName() == name)
+                    return true;
+            }
+
+            return false;
+        }
+
+        OnDemandValue operator[](const std::string& name)
+        {
+            OnDemandValue value;
+            if (!findField(name, value))
+                throw makeError(ParserError::UnknownField);
+
+            return value;
+        }
+
+        iterator begin() { return iterator{this}; }
+        iterator end() { return iterator{}; }
+
+    private:
+        friend class OnDemandDocument<X>;
+
+        OnDemandValue(OnDemandDocument<X>& doc, std::size_t depth)
+            : m_doc{&doc}, m_depth{depth}, m_type{doc.m_parser.getType()}
+        {
+        }
+
+        void checkType(Type type) const
+        {
+            if (m_type != type)
+                throw makeError(ParserError::UnexpectedType);
+        }
+
+        ParserError makeError(ParserError::Type type) const
+        {
+            return m_doc->m_parser.makeError(type);
+        }
+
+        bool finish()
+        {
+            m_finished = true;
+            m_doc->m_depth = m_depth;
+            return false;
+        }
+
+        OnDemandDocument<X>* m_doc;
+        std::size_t m_depth;
+        Type m_type;
+        bool m_started{false};
+        bool m_finished{false};
+    };
+
+    template<class X>
+    class OnDemandValue<X>::iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = OnDemandValue<X>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = OnDemandValue<X>*;
+        using reference = OnDemandValue<X>&;
+
+        iterator() : m_container{nullptr} {}
+        explicit iterator(OnDemandValue<X>* container) : m_container{container} { ++*this; }
+
+        OnDemandValue<X>& operator*() { return m_current; }
+        OnDemandValue<X>* operator->() { return &m_current; }
+
+        iterator& operator++()
+        {
+            if (!m_container->next(m_current))
+                m_container = nullptr;
+            return *this;
+        }
+
+        bool operator==(const iterator& rhs) const { return m_container == rhs.m_container; }
+        bool operator!=(const iterator& rhs) const { return !this->operator==(rhs); }
+
+    private:
+        OnDemandValue<X>* m_container;
+        OnDemandValue<X> m_current;
+    };
+
+    template<class X>
+    class OnDemandDocument
+    {
+    public:
+        template<typename InputIterator>
+        OnDemandDocument(InputIterator first, InputIterator last)
+            : m_parser{first, last}
+        {
+            onValue();
+            m_root = OnDemandValue<X>{*this, 0};
+        }
+
+        OnDemandDocument(OnDemandDocument&& rhs)
+            : m_parser(std::move(rhs.m_parser)), m_root(rhs.m_root)
+            , m_depth{rhs.m_depth}, m_pending{rhs.m_pending}
+        {
+            m_root.m_doc = this;
+        }
+
+        OnDemandDocument(const OnDemandDocument&) = delete;
+        void operator=(const OnDemandDocument&) = delete;
+
+        OnDemandValue<X>& root() { return m_root; }
+
+        OnDemandValue<X> operator[](const std::string& name) { return m_root[name]; }
+
+    private:
+        friend class OnDemandValue<X>;
+
+        void onValue()
+        {
+            switch (m_parser.getType())
+            {
+            case Type::Array: case Type::Object: ++m_depth; break;
+            case Type::String: m_pending = true; break;
+            default: break;
+            }
+        }
+
+        void skipTo(std::size_t depth)
+        {
+            if (m_pending)
+            {
+                m_parser.skipValue();
+                m_pending = false;
+            }
+
+            for (; m_depth > depth; --m_depth)
+                m_parser.skipListRest();
+        }
+
+        Parser<X> m_parser;
+        OnDemandValue<X> m_root;
+        std::size_t m_depth{0};  // number of containers the parser is inside
+        bool m_pending{false};   // the current string value has not been consumed
+    };
+
+    template<typename CharT, typename InputIterator>
+    inline OnDemandDocument<details::Traits2<CharT, InputIterator>>
+        parse_on_demand(InputIterator first, InputIterator last)
+    {
+        return {first, last};
+    }
+
+    template<typename CharT>
+    inline OnDemandDocument<details::Traits2<CharT, details::CStrIterator<CharT>>>
+        parse_on_demand(const CharT* str)
+    {
+        details::CStrIterator<CharT> first{str}, last;
+        return parse_on_demand<CharT>(first, last);
+    }
+
+    // The document points into the string, so it must outlive the document
+    template<typename CharT>
+    inline OnDemandDocument<details::Traits2<CharT, const CharT*>>
+        parse_on_demand(const std::basic_string<CharT>& str)
+    {
+        return parse_on_demand<CharT>(str.data(), str.data() + str.size());
+    }
+
+    template<typename CharT>
+    void parse_on_demand(std::basic_string<CharT>&& str) = delete;
+
+    template<typename CharT>
+    inline OnDemandDocument<details::Traits2<CharT, std::istreambuf_iterator<CharT>>>
+        parse_on_demand(std::basic_istream<CharT>& stream)
+    {
+        std::istreambuf_iterator<CharT> first{stream}, last;
+        return parse_on_demand<CharT>(first, last);
+    }
+}
@@ -0,0 +1,165 @@
+// JSON for C++ : parallel generation of large arrays
+// Belongs to the public domain
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <json-cpp/generate.hpp>
+
+namespace jsoncpp
+{
+    struct ParallelOptions
+    {
+        unsigned threads{0};          // 0 means std::thread::hardware_concurrency()
+        std::size_t chunkSize{4096};  // number of elements serialized by one task
+    };
+
+    namespace details
+    {
+        // Statistics are collected by one generator, so only generators without them write in parallel.
+        // Workers format numbers with `formatNumber`, so the sink must format them the same way.
+        template<class X>
+        inline bool generatesInParallel(Generator<X>&)
+        {
+            return false;
+        }
+
+        template<typename CharT, typename Sink>
+        inline bool generatesInParallel(Generator<Traits2<CharT, Sink, NoStats>>& generator)
+        {
+            return generator.hasDefaultNumberFormat();
+        }
+
+        // Joins the threads which were started, even if starting the next one throws
+        struct ThreadJoiner
+        {
+            ~ThreadJoiner()
+            {
+                for (auto& thread : threads)
+                    thread.join();
+            }
+
+            std::vector<std::thread> threads;
+        };
+    }
+
+    // Same as `writeRange`, but chunks of the range are serialized concurrently into separate buffers,
+    // which are then passed to the sink in order. The range must be random-access.
+    // Workers write with the options of `generator`, so the output is identical to `writeRange`.
+    // Sinks which format numbers differently, e.g. streams with another precision, are written sequentially.
+    template<class X, typename Range>
+    inline void writeRangeParallel(Generator<X>& generator, Range& range, const ParallelOptions& options = ParallelOptions())
+    {
+        auto first = std::begin(range);
+        auto size = static_cast<std::size_t>(std::end(range) - first);
+        auto chunkSize = std::max<std::size_t>(options.chunkSize, 1);
+        auto chunkCount = (size + chunkSize - 1) / chunkSize;
+        auto threadCount = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+        if (chunkCount < 2 || threadCount < 2 || !details::generatesInParallel(generator))
+        {
+            writeRange(generator, range);
+            return;
+        }
+
+        std::vector<std::string> chunks(chunkCount);
+        std::atomic<std::size_t> nextChunk{0};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto& generatorOptions = generator.options();
+
+        auto worker = [&]
+        {
+            try
+            {
+                std::ostringstream rawStream;
+                rawStream.imbue(std::locale::classic());
+                for (std::size_t idx; (idx = nextChunk++) < chunkCount;)
+                {
+                    rawStream.str(std::string());
+                    Generator<details::Traits2<char, std::ostream>> stream{rawStream, generatorOptions};
+
+                    auto iter = first + idx * chunkSize;
+                    auto last = iter + std::min(chunkSize, size - idx * chunkSize);
+                    for (;;)
+                    {
+                        serialize(stream, *iter);
+
+                        ++iter;
+                        if (iter == last)
+                            break;
+
+                        stream.separator();
+                    }
+
+                    chunks[idx] = rawStream.str();
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{errorMutex};
+                if (!error)
+                    error = std::current_exception();
+
+                nextChunk = chunkCount;
+            }
+        };
+
+        {
+            details::ThreadJoiner pool;
+            try
+            {
+                for (auto i = 1U; i < std::min<std::size_t>(threadCount, chunkCount); ++i)
+                    pool.threads.emplace_back(worker);
+            }
+            catch (...)
+            {
+                // The running workers stop after their current chunk
+                nextChunk = chunkCount;
+                throw;
+            }
+
+            worker();
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        generator.arrayBegin();
+        for (std::size_t idx = 0; idx != chunkCount; ++idx)
+        {
+            if (idx != 0)
+                generator.separator();
+
+            generator.writeRaw(chunks[idx].data(), chunks[idx].size());
+        }
+
+        generator.arrayEnd();
+    }
+
+    template<class Range>
+    inline std::string to_string_parallel(const Range& range, const GeneratorOptions& generatorOptions,
+        const ParallelOptions& options = ParallelOptions())
+    {
+        std::ostringstream rawStream;
+        Generator<details::Traits2<char, std::ostream>> stream{rawStream, generatorOptions};
+        writeRangeParallel(stream, const_cast<Range&>(range), options);
+        return rawStream.str();
+    }
+
+    template<class Range>
+    inline std::string to_string_parallel(const Range& range, const ParallelOptions& options = ParallelOptions())
+    {
+        return to_string_parallel(range, GeneratorOptions(), options);
+    }
+}
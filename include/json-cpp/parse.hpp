@@ -3,51 +3,99 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstddef>
 #include <memory>
 #include <istream>
 #include <iterator>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include <json-cpp/ParserError.hpp>
 #include <json-cpp/Stream.hpp>
 #include <json-cpp/value_types.hpp>
+#include <json-cpp/details/no_stats.hpp>
 #include <json-cpp/details/parser_utility.hpp>
 #include <json-cpp/details/number_parser.hpp>
 #include <json-cpp/details/string_parser.hpp>
 
 namespace jsoncpp
 {
-    template<typename CharT, typename InputIterator>
-    class Stream<details::ParserTraits<details::Traits2<CharT, InputIterator>>>
+    struct ParserOptions
+    {
+        // Reject strings with malformed UTF-8 with `ParserError::InvalidUtf8`.
+        // Skipped values aren't checked.
+        bool validateUtf8{false};
+
+        // Count the items of arrays and objects ahead, so containers are reserved once.
+        // Only contiguous input is scanned, and nested lists are scanned again for each level,
+        // so it pays off for large flat arrays and costs extra work for deeply nested documents.
+        bool reserveContainers{false};
+
+        // Parse into the existing elements of containers instead of clearing them, so their strings and vectors
+        // keep their capacity: arrays only grow or shrink at the tail, and maps keep the keys which aren't in the input.
+        bool updateInPlace{false};
+    };
+
+    template<typename CharT, typename InputIterator, class StatsPolicy>
+    class Stream<details::ParserTraits<details::Traits2<CharT, InputIterator, StatsPolicy>>>
     {
     public:
-        using this_type = Parser<details::Traits2<CharT, InputIterator>>;
+        using this_type = Parser<details::Traits2<CharT, InputIterator, StatsPolicy>>;
+        using char_type = typename details::Reader<InputIterator>::char_type;
+
+        explicit Stream(InputIterator first, InputIterator last, StatsPolicy stats = StatsPolicy{})
+            : m_reader{first, last}, m_stats(stats)
+        {
+            nextValue();
+        }
 
-        explicit Stream(InputIterator first, InputIterator last)
-            : m_reader{first, last}
+        Stream(InputIterator first, InputIterator last, const ParserOptions& options, StatsPolicy stats = StatsPolicy{})
+            : m_reader{first, last}, m_options(options), m_stats(stats)
         {
             nextValue();
         }
 
         Type getType() const { return m_type; }
         bool getBoolean() const { return m_boolean; }
-        double getNumber() const { return m_number; }
+        double getNumber() const { return m_number.to<double>(); }
+        float getFloat() const { return m_number.to<float>(); }
+
+        // The exact value for integral targets, false if it isn't a 64-bit integer
+        bool getInteger(details::IntegerNumber& number) const { return m_number.toInteger(number); }
         const std::string& getFieldName() const { return m_fieldName; }
 
+        const details::FieldMask* getFieldMask() const { return m_fieldMask; }
+        void setFieldMask(const details::FieldMask* mask) { m_fieldMask = mask; }
+
+        const ParserOptions& options() const { return m_options; }
+        StatsPolicy& stats() { return m_stats; }
+
         void checkType(Type type) const
         {
             if (getType() != type)
                 throw makeError(ParserError::UnexpectedType);
         }
 
+        // The number of items of the current array or object, if it's known ahead, 0 otherwise.
+        // It's only a hint for reserving, it's valid before the first item is parsed.
+        std::size_t listSizeHint() const
+        {
+            if (!m_options.reserveContainers || (m_type != Type::Array && m_type != Type::Object))
+                return 0;
+
+            return details::countListItems(m_reader);
+        }
+
         bool isListEnd(char terminator)
         {
             eatWhitespace();
-            if (*m_reader != terminator)
+            if (*m_reader != static_cast<char_type>(terminator))
                 return false;
 
             ++m_reader;
+            m_stats.listEnd();
             return true;
         }
 
@@ -72,14 +120,61 @@ namespace jsoncpp
         {
             eatWhitespace();
             m_type = nextValueImpl();
+            m_stats.value(m_type);
         }
 
-        template<typename DstCharT>
-        void parseString(std::basic_string<DstCharT>& str)
+        // `Str` is a `std::basic_string` or a string with the same members, see `parseStringImpl`
+        template<class Str>
+        void parseString(Str& str)
         {
-            auto err = parseStringImpl(m_reader, str);
+            auto capacity = str.capacity();
+            auto err = parseStringImpl(m_reader, str, m_options.validateUtf8);
             if (err != ParserError::NoError)
                 throw m_reader.m_diag.makeError(err);
+
+            m_stats.parsedString(str.size(), str.capacity() != capacity);
+        }
+
+        // Parses the current array into a vector of numbers, it's the same as parsing the items one by one,
+        // but numbers are parsed in a tight loop
+        template<typename T, class Alloc>
+        void parseNumberArray(std::vector<T, Alloc>& arr)
+        {
+            checkType(Type::Array);
+            arr.clear();
+            arr.reserve(listSizeHint());
+
+            for (;;)
+            {
+                if (isListEnd(']'))
+                    return;
+
+                switch (*m_reader)
+                {
+                case '0': case '1': case '2': case '3': case '4':
+                case '5': case '6': case '7': case '8': case '9': case '-':
+                    {
+                        auto err = parseNumberImpl(m_reader, m_number);
+                        if (err != ParserError::NoError)
+                            throw makeError(err);
+                    }
+                    m_type = Type::Number;
+                    m_stats.value(m_type);
+                    break;
+
+                default:
+                    nextValue();
+                    break;
+                }
+
+                arr.emplace_back();
+                serialize(*this, arr.back());
+
+                if (isListEnd(']'))
+                    return;
+
+                eatListSeparator();
+            }
         }
 
         ParserError makeError(ParserError::Type type) const
@@ -87,6 +182,47 @@ namespace jsoncpp
             return m_reader.m_diag.makeError(type);
         }
 
+        // Skips the rest of the current value without decoding it
+        void skipValue()
+        {
+            m_stats.skipped();
+            switch (m_type)
+            {
+            case Type::String: details::skipStringImpl(m_reader); break;
+            case Type::Array: case Type::Object: skipListRest(); break;
+            default: break;
+            }
+        }
+
+        // Skips the rest of the innermost array or object, including its terminator.
+        // Skipped content is only checked for bracket balance, not validated.
+        void skipListRest()
+        {
+            for (auto depth = 1U; depth != 0;)
+            {
+                auto ch = *m_reader;
+                ++m_reader;
+                switch (ch)
+                {
+                case '"': details::skipStringImpl(m_reader); break;
+                case '{': case '[': ++depth; break;
+                case '}': case ']': --depth; break;
+
+                case '/':
+                    check('/');
+                    while (*m_reader != '\n')
+                        ++m_reader;
+                    break;
+
+                case '\n':
+                    m_reader.m_diag.newLine();
+                    break;
+                }
+            }
+
+            m_stats.listEnd();
+        }
+
     private:
         Type nextValueImpl()
         {
@@ -100,13 +236,12 @@ namespace jsoncpp
             case '"': ++m_reader; return Type::String;
 
             case '0': case '1': case '2': case '3': case '4':
-            case '5': case '6': case '7': case '8': case '9':
-                m_number = parseRealNumber(m_reader);
-                return Type::Number;
-
-            case '-':
-                ++m_reader;
-                m_number = -parseRealNumber(m_reader);
+            case '5': case '6': case '7': case '8': case '9': case '-':
+                {
+                    auto err = parseNumberImpl(m_reader, m_number);
+                    if (err != ParserError::NoError)
+                        throw makeError(err);
+                }
                 return Type::Number;
             }
 
@@ -120,7 +255,7 @@ namespace jsoncpp
 
         void check(char expectedChar)
         {
-            if (*m_reader != expectedChar)
+            if (*m_reader != static_cast<char_type>(expectedChar))
                 throw unexpectedCharacter();
 
             ++m_reader;
@@ -131,7 +266,7 @@ namespace jsoncpp
         {
             static_assert(N > 2, "");
             for (auto i = 1; i != N - 1; ++i, ++m_reader)
-                if (*m_reader != literal[i])
+                if (*m_reader != static_cast<char_type>(literal[i]))
                     throw unexpectedCharacter();
         }
 
@@ -164,9 +299,12 @@ namespace jsoncpp
         details::Reader<InputIterator> m_reader;
 
         Type m_type;
-        double m_number;
+        details::DecimalNumber m_number;
         bool m_boolean;
         std::string m_fieldName;
+        const details::FieldMask* m_fieldMask{nullptr};
+        ParserOptions m_options;
+        StatsPolicy m_stats;
     };
 
     template<class X>
@@ -176,19 +314,38 @@ namespace jsoncpp
         value = parser.getBoolean();
     }
 
+    // Integers are converted from the exact value, a fraction or a value out of the range of `T` is an error
     template<class X, typename T>
-    inline typename std::enable_if<std::is_arithmetic<T>::value>::type
+    inline typename std::enable_if<std::is_integral<T>::value>::type
         serialize(Parser<X>& parser, T& value)
     {
         parser.checkType(Type::Number);
-        auto number = parser.getNumber();
-        value = static_cast<T>(number);
-        if (value != number)
+        details::IntegerNumber number;
+        auto err = parser.getInteger(number) ? details::toInteger(number, value) : ParserError::NumberIsOutOfRange;
+        if (err != ParserError::NoError)
+            throw parser.makeError(err);
+    }
+
+    template<class X, typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value>::type
+        serialize(Parser<X>& parser, T& value)
+    {
+        parser.checkType(Type::Number);
+        value = static_cast<T>(parser.getNumber());
+    }
+
+    // Rounded to the nearest float, only overflow is an error
+    template<class X>
+    inline void serialize(Parser<X>& parser, float& value)
+    {
+        parser.checkType(Type::Number);
+        value = parser.getFloat();
+        if (std::isinf(value) && !std::isinf(parser.getNumber()))
             throw parser.makeError(ParserError::NumberIsOutOfRange);
     }
 
-    template<class X, typename DstCharT>
-    inline void serialize(Parser<X>& parser, std::basic_string<DstCharT>& value)
+    template<class X, typename DstCharT, class Traits, class Alloc>
+    inline void serialize(Parser<X>& parser, std::basic_string<DstCharT, Traits, Alloc>& value)
     {
         parser.checkType(Type::String);
         parser.parseString(value);
@@ -196,6 +353,19 @@ namespace jsoncpp
 
     namespace details
     {
+        // Only the JSON parser has options
+        template<class X>
+        inline bool updatesInPlace(Parser<X>&)
+        {
+            return false;
+        }
+
+        template<typename CharT, typename Iterator, class StatsPolicy>
+        inline bool updatesInPlace(Parser<Traits2<CharT, Iterator, StatsPolicy>>& parser)
+        {
+            return parser.options().updateInPlace;
+        }
+
         template<class X, typename Callback>
         inline void parseList(Parser<X>& parser, Type type, char terminator, Callback&& callback)
         {
@@ -247,10 +417,11 @@ namespace jsoncpp
         parse<CharT>(object, first, last);
     }
 
+    // Contiguous input is read through pointers, which enables the fast paths
     template<typename T, typename CharT>
     inline void parse(T& object, const std::basic_string<CharT>& str)
     {
-        parse<CharT>(object, std::begin(str), std::end(str));
+        parse<CharT>(object, str.data(), str.data() + str.size());
     }
 
     template<typename T, typename CharT>
@@ -259,4 +430,31 @@ namespace jsoncpp
         std::istreambuf_iterator<CharT> first{stream}, last;
         parse<CharT>(object, first, last);
     }
+
+    template<typename CharT, class T, typename InputIterator>
+    inline void parse(T& object, InputIterator first, InputIterator last, const ParserOptions& options)
+    {
+        Parser<details::Traits2<CharT, InputIterator>> stream{first, last, options};
+        serialize(stream, object);
+    }
+
+    template<typename T, typename CharT>
+    inline void parse(T& object, const CharT* str, const ParserOptions& options)
+    {
+        details::CStrIterator<CharT> first{str}, last;
+        parse<CharT>(object, first, last, options);
+    }
+
+    template<typename T, typename CharT>
+    inline void parse(T& object, const std::basic_string<CharT>& str, const ParserOptions& options)
+    {
+        parse<CharT>(object, str.data(), str.data() + str.size(), options);
+    }
+
+    template<typename T, typename CharT>
+    inline void parse(T& object, std::basic_istream<CharT>& stream, const ParserOptions& options)
+    {
+        std::istreambuf_iterator<CharT> first{stream}, last;
+        parse<CharT>(object, first, last, options);
+    }
 }
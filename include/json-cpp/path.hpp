@@ -0,0 +1,178 @@
+// JSON for C++ : streaming extraction of values by path
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json-cpp/parse.hpp>
+
+namespace jsoncpp
+{
+    // A compiled JSON Pointer (RFC 6901), extended with `*` matching any field or array element,
+    // e.g. "/events/*/user/id".
+    class Path
+    {
+    public:
+        struct Segment
+        {
+            std::string name;
+            std::size_t index;
+            bool isIndex;
+            bool isWildcard;
+
+            bool matches(const std::string& fieldName) const { return isWildcard || fieldName == name; }
+            bool matches(std::size_t idx) const { return isWildcard || (isIndex && idx == index); }
+        };
+
+        explicit Path(const std::string& expr)
+        {
+            if (expr.empty())
+                return;
+
+            if (expr[0] != '/')
+                throw std::invalid_argument("JSON path must start with '/'");
+
+            for (std::size_t pos = 1;;)
+            {
+                auto end = expr.find('/', pos);
+                if (end == std::string::npos)
+                    end = expr.size();
+
+                m_segments.push_back(makeSegment(expr, pos, end));
+                if (end == expr.size())
+                    break;
+
+                pos = end + 1;
+            }
+        }
+
+        std::size_t size() const { return m_segments.size(); }
+        const Segment& operator[](std::size_t idx) const { return m_segments[idx]; }
+
+    private:
+        static Segment makeSegment(const std::string& expr, std::size_t first, std::size_t last)
+        {
+            Segment segment{std::string{}, 0, last != first, false};
+            for (auto pos = first; pos != last; ++pos)
+            {
+                auto ch = expr[pos];
+                if (ch == '~')
+                {
+                    if (++pos == last || (expr[pos] != '0' && expr[pos] != '1'))
+                        throw std::invalid_argument("invalid escape sequence in JSON path");
+
+                    ch = expr[pos] == '0' ? '~' : '/';
+                }
+
+                segment.isIndex = segment.isIndex && ch >= '0' && ch <= '9';
+                if (segment.isIndex)
+                    segment.index = segment.index * 10 + (ch - '0');
+
+                segment.name.push_back(ch);
+            }
+
+            // RFC 6901 array indices have no leading zeros, such tokens and too large numbers are only names
+            if (segment.isIndex && ((segment.name.size() > 1 && segment.name[0] == '0')
+                || segment.name.size() > std::numeric_limits<std::size_t>::digits10))
+                segment.isIndex = false;
+
+            segment.isWildcard = expr.compare(first, last - first, "*") == 0;
+            return segment;
+        }
+
+        std::vector<Segment> m_segments;
+    };
+
+    namespace details
+    {
+        template<class X, typename Callback>
+        inline void matchPath(Parser<X>& parser, const Path& path, std::size_t level, Callback& callback)
+        {
+            if (level == path.size())
+            {
+                callback(parser);
+                return;
+            }
+
+            const auto& segment = path[level];
+            switch (parser.getType())
+            {
+            case Type::Object:
+                parseObject(parser, [&](const std::string& fieldName)
+                {
+                    if (segment.matches(fieldName))
+                        matchPath(parser, path, level + 1, callback);
+                    else
+                        parser.skipValue();
+                });
+                break;
+
+            case Type::Array:
+                {
+                    std::size_t idx = 0;
+                    parseArray(parser, [&]
+                    {
+                        if (segment.matches(idx++))
+                            matchPath(parser, path, level + 1, callback);
+                        else
+                            parser.skipValue();
+                    });
+                }
+                break;
+
+            default:
+                parser.skipValue();
+                break;
+            }
+        }
+    }
+
+    // Calls `callback(parser)` for each value matching the path, the callback must consume the value
+    // either with `serialize()` or with `parser.skipValue()`.
+    // Non-matching values are skipped, memory usage is bounded by the nesting depth of the path.
+    template<class X, typename Callback>
+    inline void matchPath(Parser<X>& parser, const Path& path, Callback&& callback)
+    {
+        details::matchPath(parser, path, 0, callback);
+    }
+
+    template<typename T, typename CharT, typename InputIterator, typename Callback>
+    inline void extract(InputIterator first, InputIterator last, const Path& path, Callback&& callback)
+    {
+        Parser<details::Traits2<CharT, InputIterator>> stream{first, last};
+        matchPath(stream, path, [&](Parser<details::Traits2<CharT, InputIterator>>& parser)
+        {
+            // Each match gets a new value, fields which it doesn't have aren't left from the previous one
+            T value{};
+            serialize(parser, value);
+            callback(value);
+        });
+    }
+
+    template<typename T, typename CharT, typename Callback>
+    inline void extract(const CharT* str, const Path& path, Callback&& callback)
+    {
+        details::CStrIterator<CharT> first{str}, last;
+        extract<T, CharT>(first, last, path, callback);
+    }
+
+    template<typename T, typename CharT, typename Callback>
+    inline void extract(const std::basic_string<CharT>& str, const Path& path, Callback&& callback)
+    {
+        extract<T, CharT>(std::begin(str), std::end(str), path, callback);
+    }
+
+    template<typename T, typename CharT, typename Callback>
+    inline void extract(std::basic_istream<CharT>& stream, const Path& path, Callback&& callback)
+    {
+        std::istreambuf_iterator<CharT> first{stream}, last;
+        extract<T, CharT>(first, last, path, callback);
+    }
+}
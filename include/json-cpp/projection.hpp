@@ -0,0 +1,70 @@
+// JSON for C++ : parsing of a subset of object fields
+// Belongs to the public domain
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include <json-cpp/parse.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+
+namespace jsoncpp
+{
+    // Binds only the selected fields of an object, all other fields are skipped without decoding.
+    // Unknown fields are still reported as errors.
+    template<class T, std::size_t N>
+    class Projection
+    {
+    public:
+        template<typename... M>
+        Projection(T& object, M T::*... members)
+            : m_object{&object}, m_fields{{&(object.*members)...}}
+        {
+        }
+
+        // Stops parsing as soon as all selected fields are filled.
+        // The rest of the input is left unread, so use it only for top-level objects.
+        Projection& stopWhenFilled()
+        {
+            m_stopWhenFilled = true;
+            return *this;
+        }
+
+        T& object() const { return *m_object; }
+
+        details::FieldMask mask() const
+        {
+            return{m_object, details::typeTag<T>(), m_fields.data(), N, m_stopWhenFilled};
+        }
+
+    private:
+        T* m_object;
+        std::array<const void*, N> m_fields;
+        bool m_stopWhenFilled{false};
+    };
+
+    template<class X, class T, std::size_t N>
+    inline void serialize(Parser<X>& parser, Projection<T, N>& projection)
+    {
+        auto mask = projection.mask();
+        auto prevMask = parser.getFieldMask();
+        parser.setFieldMask(&mask);
+        serialize(parser, projection.object());
+        parser.setFieldMask(prevMask);
+    }
+
+    template<class T, typename... M>
+    inline Projection<T, sizeof...(M)> project(T& object, M T::*... members)
+    {
+        return{object, members...};
+    }
+
+    template<typename T, typename Input, typename... M>
+    inline void parse_only(T& object, Input&& input, M T::*... members)
+    {
+        auto projection = project(object, members...);
+        parse(projection, std::forward<Input>(input));
+    }
+}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <typeinfo>
 #include <unordered_map>
 
 #include <json-cpp/parse.hpp>
@@ -14,18 +15,21 @@ namespace jsoncpp
     namespace details
     {
         template<class X, typename T>
-        inline void writeField(Generator<X>& generator, const char* name, T& value)
+        inline void writeField(Generator<X>& generator, const std::type_info& type, const char* name, T& value)
         {
+            auto&& stats = streamStats(generator);
+            auto start = stats.profileBegin();
             generator.fieldName(name);
             serialize(generator, value);
+            stats.profileEnd(start, type, name);
         }
 
         template<class X, typename T, typename... F>
-        inline void writeField(Generator<X>& generator, const char* name, T& value, F&&... fieldsDef)
+        inline void writeField(Generator<X>& generator, const std::type_info& type, const char* name, T& value, F&&... fieldsDef)
         {
-            writeField(generator, name, value);
+            writeField(generator, type, name, value);
             generator.separator();
-            writeField(generator, fieldsDef...);
+            writeField(generator, type, fieldsDef...);
         }
 
         template<typename ParserT>
@@ -42,9 +46,10 @@ namespace jsoncpp
             struct FieldInfo
             {
                 template<typename T>
-                FieldInfo(T&, std::size_t idx)
+                FieldInfo(T&, std::size_t idx, const char* name)
                 {
                     m_fieldIdx = idx;
+                    m_name = name;
                     m_parseFn = [](ParserT& parser, void* fieldPtr)
                     {
                         serialize(parser, static_cast<T&>(*reinterpret_cast<T*>(fieldPtr)));
@@ -52,6 +57,7 @@ namespace jsoncpp
                 }
 
                 std::size_t m_fieldIdx;
+                const char* m_name;
                 void(*m_parseFn)(ParserT& parser, void* fieldPtr);
             };
 
@@ -65,7 +71,7 @@ namespace jsoncpp
             template<typename T, typename... F>
             void add(std::size_t idx, const char* name, T& value, F&&... otherFields)
             {
-                m_map.emplace(name, FieldInfo(value, idx));
+                m_map.emplace(name, FieldInfo(value, idx, name));
                 add(idx + 2, otherFields...);
             }
 
@@ -78,33 +84,90 @@ namespace jsoncpp
 
         template<typename T>
         inline void* makePtrs(T& obj) { return &obj; }
+
+        template<class X, typename Table, std::size_t N>
+        inline void parseMaskedFields(Parser<X>& parser, const Table& table,
+            const std::array<void*, N>& ptrs, const FieldMask& mask)
+        {
+            std::array<bool, N> isFilled{};
+            std::size_t filledCount = 0;
+
+            parser.checkType(Type::Object);
+            while (!parser.isListEnd('}'))
+            {
+                parser.nextNameValuePair();
+                auto fieldInfo = table.find(parser.getFieldName());
+                if (fieldInfo == nullptr)
+                    throw parser.makeError(ParserError::UnknownField);
+
+                auto fieldPtr = ptrs[fieldInfo->m_fieldIdx];
+                if (!mask.contains(fieldPtr))
+                {
+                    parser.skipValue();
+                }
+                else
+                {
+                    fieldInfo->m_parseFn(parser, fieldPtr);
+
+                    if (!isFilled[fieldInfo->m_fieldIdx])
+                    {
+                        isFilled[fieldInfo->m_fieldIdx] = true;
+                        if (++filledCount == mask.size && mask.stopWhenFilled)
+                            return;
+                    }
+                }
+
+                if (parser.isListEnd('}'))
+                    return;
+
+                parser.eatListSeparator();
+            }
+        }
     }
 
     template<class Cls, class X, typename... F>
-    inline void fields(Cls&, Parser<X>& parser, F&&... fieldsDef)
+    inline void fields(Cls& obj, Parser<X>& parser, F&&... fieldsDef)
     {
         std::array<void*, sizeof...(fieldsDef)> ptrs{details::makePtrs(fieldsDef)...};
 
         static const details::FieldsTable<Parser<X>> table{fieldsDef...};
-        
+
+        auto&& stats = details::streamStats(parser);
+        auto start = stats.profileBegin();
+
+        auto mask = parser.getFieldMask();
+        if (mask != nullptr && mask->isFor(obj))
+        {
+            parser.setFieldMask(nullptr);
+            details::parseMaskedFields(parser, table, ptrs, *mask);
+            stats.profileEnd(start, typeid(Cls), nullptr);
+            return;
+        }
+
         auto&& handler = [&](const std::string& fieldName)
         {
             auto fieldInfo = table.find(fieldName);
             if (fieldInfo == nullptr)
                 throw parser.makeError(ParserError::UnknownField);
 
+            auto fieldStart = stats.profileBegin();
             auto fieldPtr = ptrs[fieldInfo->m_fieldIdx];
             fieldInfo->m_parseFn(parser, fieldPtr);
+            stats.profileEnd(fieldStart, typeid(Cls), fieldInfo->m_name);
         };
 
         parseObject(parser, handler);
+        stats.profileEnd(start, typeid(Cls), nullptr);
     }
 
     template<class Cls, class X, typename... F>
     inline void fields(Cls&, Generator<X>& generator, F&&... fieldsDef)
     {
+        auto&& stats = details::streamStats(generator);
+        auto start = stats.profileBegin();
         generator.objectBegin();
-        details::writeField(generator, fieldsDef...);
+        details::writeField(generator, typeid(Cls), fieldsDef...);
         generator.objectEnd();
+        stats.profileEnd(start, typeid(Cls), nullptr);
     }
 }
@@ -0,0 +1,577 @@
+// JSON for C++ : memory-mappable binary snapshot
+// Belongs to the public domain
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <json-cpp/ParserError.hpp>
+#include <json-cpp/Stream.hpp>
+#include <json-cpp/value_types.hpp>
+#include <json-cpp/generate.hpp>
+#include <json-cpp/string_ref.hpp>
+#include <json-cpp/details/string_parser.hpp>
+
+namespace jsoncpp
+{
+    namespace details
+    {
+        // Snapshot layout, all values are stored in the native byte order:
+        //   header: u32 magic, u32 version, u64 root offset, u64 snapshot size, u64 reserved
+        //   node:   u32 tag, u32 size, payload; every node starts at a multiple of 8
+        // Payloads: Null - none, Boolean - none (the size is the value), Integer - i64, Double - f64,
+        // Unsigned - u64 above the range of i64 (since version 2), String - `size` bytes and a terminating zero, Array - `size` u64 offsets of elements,
+        // Object - `size` pairs of u64 offsets of the field name and the value, sorted by name.
+        template<typename T>
+        struct SnapshotTraits {};
+
+        const std::uint32_t SnapshotMagic = 0x504E534A;
+        const std::uint32_t SnapshotVersion = 2;
+        const std::size_t SnapshotHeaderSize = 32;
+        const std::size_t SnapshotAlignment = 8;
+
+        enum class SnapshotTag : std::uint32_t
+        {
+            Null = 1, Boolean, Integer, Double, String, Array, Object, Unsigned,
+        };
+
+        template<typename T>
+        inline T loadSnapshot(const char* base, std::uint64_t offset)
+        {
+            T value;
+            std::memcpy(&value, base + offset, sizeof(value));
+            return value;
+        }
+
+        inline int compareNames(const char* a, std::size_t aSize, const char* b, std::size_t bSize)
+        {
+            auto result = std::memcmp(a, b, std::min(aSize, bSize));
+            if (result != 0)
+                return result;
+
+            return aSize < bSize ? -1 : aSize > bSize ? 1 : 0;
+        }
+    }
+
+    // Writes a snapshot to a `std::string`.
+    // Children are written before their parents, so a list is kept as a list of offsets until it ends.
+    // Field names are written once, names passed as `const char*` are looked up by the pointer first,
+    // and the name stored for it is compared with the string, so a reused buffer doesn't get a stale name.
+    template<>
+    class Stream<details::GeneratorTraits<details::SnapshotTraits<std::string>>>
+    {
+    public:
+        using this_type = Generator<details::SnapshotTraits<std::string>>;
+
+        // Offsets are counted from the current end of `sink`
+        explicit Stream(std::string& sink)
+            : m_sink(&sink), m_base{sink.size()}
+        {
+            m_sink->append(details::SnapshotHeaderSize, '\0');
+        }
+
+        void objectBegin() { listBegin(true); }
+        void objectEnd() { listEnd(details::SnapshotTag::Object); }
+        void arrayBegin() { listBegin(false); }
+        void arrayEnd() { listEnd(details::SnapshotTag::Array); }
+        void separator() {}
+
+        void fieldName(const char* name)
+        {
+            auto size = std::strlen(name);
+            auto it = m_literalNames.find(name);
+            if (it == m_literalNames.end())
+                it = m_literalNames.emplace(name, nameOffset(name, size)).first;
+            else if (!isStoredName(it->second, name, size))
+                it->second = nameOffset(name, size);
+
+            m_lists[m_depth - 1].name = it->second;
+        }
+
+        template<typename StrCharT, class Traits, class Alloc>
+        void fieldName(const std::basic_string<StrCharT, Traits, Alloc>& name)
+        {
+            std::string utf8;
+            details::wideToUtf8(name, utf8);
+            fieldName(utf8);
+        }
+
+        template<class Traits, class Alloc>
+        void fieldName(const std::basic_string<char, Traits, Alloc>& name)
+        {
+            fieldName(std::string(name.data(), name.size()));
+        }
+
+        void fieldName(const StringRef& name)
+        {
+            fieldName(name.str());
+        }
+
+        void fieldName(const std::string& name)
+        {
+            m_lists[m_depth - 1].name = nameOffset(name);
+        }
+
+        friend void serialize(this_type& stream, std::nullptr_t)
+        {
+            stream.addItem(stream.beginNode(details::SnapshotTag::Null, 0));
+        }
+
+        friend void serialize(this_type& stream, bool value)
+        {
+            stream.addItem(stream.beginNode(details::SnapshotTag::Boolean, value ? 1 : 0));
+        }
+
+        template<typename T>
+        friend typename std::enable_if<std::is_arithmetic<T>::value>::type serialize(this_type& stream, T& value)
+        {
+            stream.addItem(stream.writeNumber(value));
+        }
+
+        template<typename SrcCharT, class Traits, class Alloc>
+        friend void serialize(this_type& stream, const std::basic_string<SrcCharT, Traits, Alloc>& value)
+        {
+            std::string utf8;
+            details::wideToUtf8(value, utf8);
+            stream.addItem(stream.writeString(utf8.data(), utf8.size()));
+        }
+
+        template<class Traits, class Alloc>
+        friend void serialize(this_type& stream, const std::basic_string<char, Traits, Alloc>& value)
+        {
+            stream.addItem(stream.writeString(value.data(), value.size()));
+        }
+
+        friend void serialize(this_type& stream, StringRef& value)
+        {
+            stream.addItem(stream.writeString(value.data, value.size));
+        }
+
+    private:
+        struct List
+        {
+            bool isObject;
+            std::uint64_t name;
+            std::vector<std::uint64_t> items;
+            std::vector<std::pair<std::uint64_t, std::uint64_t>> fields;
+        };
+
+        template<typename T>
+        void store(T value)
+        {
+            m_sink->append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        std::uint64_t beginNode(details::SnapshotTag tag, std::size_t size)
+        {
+            if (size > UINT32_MAX)
+                throw std::length_error("jsoncpp: snapshot node is too large");
+
+            auto padding = (details::SnapshotAlignment - (m_sink->size() - m_base) % details::SnapshotAlignment) % details::SnapshotAlignment;
+            m_sink->append(padding, '\0');
+
+            auto offset = static_cast<std::uint64_t>(m_sink->size() - m_base);
+            store(static_cast<std::uint32_t>(tag));
+            store(static_cast<std::uint32_t>(size));
+            return offset;
+        }
+
+        // The last completed top-level value becomes the root
+        void addItem(std::uint64_t offset)
+        {
+            if (m_depth == 0)
+            {
+                std::uint32_t prefix[2] = {details::SnapshotMagic, details::SnapshotVersion};
+                std::uint64_t layout[3] = {offset, m_sink->size() - m_base, 0};
+
+                auto header = &(*m_sink)[m_base];
+                std::memcpy(header, prefix, sizeof(prefix));
+                std::memcpy(header + sizeof(prefix), layout, sizeof(layout));
+                return;
+            }
+
+            auto& list = m_lists[m_depth - 1];
+            if (list.isObject)
+                list.fields.emplace_back(list.name, offset);
+            else
+                list.items.push_back(offset);
+        }
+
+        void listBegin(bool isObject)
+        {
+            if (m_depth == m_lists.size())
+                m_lists.emplace_back();
+
+            auto& list = m_lists[m_depth++];
+            list.isObject = isObject;
+            list.items.clear();
+            list.fields.clear();
+        }
+
+        void listEnd(details::SnapshotTag tag)
+        {
+            auto& list = m_lists[--m_depth];
+            std::uint64_t offset;
+            if (list.isObject)
+            {
+                auto base = m_sink->data() + m_base;
+                std::sort(list.fields.begin(), list.fields.end(), [base](const std::pair<std::uint64_t, std::uint64_t>& a, const std::pair<std::uint64_t, std::uint64_t>& b)
+                {
+                    return details::compareNames(
+                        base + a.first + 8, details::loadSnapshot<std::uint32_t>(base, a.first + 4),
+                        base + b.first + 8, details::loadSnapshot<std::uint32_t>(base, b.first + 4)) < 0;
+                });
+
+                offset = beginNode(tag, list.fields.size());
+                for (auto& field : list.fields)
+                {
+                    store(field.first);
+                    store(field.second);
+                }
+            }
+            else
+            {
+                offset = beginNode(tag, list.items.size());
+                m_sink->append(reinterpret_cast<const char*>(list.items.data()), list.items.size() * sizeof(std::uint64_t));
+            }
+
+            addItem(offset);
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_integral<T>::value, std::uint64_t>::type writeNumber(T value)
+        {
+            if (std::is_unsigned<T>::value && static_cast<std::uint64_t>(value) > static_cast<std::uint64_t>(INT64_MAX))
+            {
+                auto offset = beginNode(details::SnapshotTag::Unsigned, 0);
+                store(static_cast<std::uint64_t>(value));
+                return offset;
+            }
+
+            auto offset = beginNode(details::SnapshotTag::Integer, 0);
+            store(static_cast<std::int64_t>(value));
+            return offset;
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, std::uint64_t>::type writeNumber(T value)
+        {
+            auto offset = beginNode(details::SnapshotTag::Double, 0);
+            store(static_cast<double>(value));
+            return offset;
+        }
+
+        std::uint64_t nameOffset(const std::string& name)
+        {
+            auto it = m_names.find(name);
+            if (it == m_names.end())
+                it = m_names.emplace(name, writeString(name.data(), name.size())).first;
+
+            return it->second;
+        }
+
+        std::uint64_t nameOffset(const char* name, std::size_t size)
+        {
+            return nameOffset(std::string(name, size));
+        }
+
+        bool isStoredName(std::uint64_t offset, const char* name, std::size_t size) const
+        {
+            auto base = m_sink->data() + m_base;
+            return details::loadSnapshot<std::uint32_t>(base, offset + 4) == size
+                && std::memcmp(base + offset + 8, name, size) == 0;
+        }
+
+        std::uint64_t writeString(const char* str, std::size_t size)
+        {
+            auto offset = beginNode(details::SnapshotTag::String, size);
+            m_sink->append(str, size);
+            m_sink->push_back('\0');
+            return offset;
+        }
+
+        std::string* m_sink;
+        std::size_t m_base;
+        std::vector<List> m_lists;
+        std::size_t m_depth{0};
+        std::unordered_map<const char*, std::uint64_t> m_literalNames;
+        std::unordered_map<std::string, std::uint64_t> m_names;
+    };
+
+    // Read-only access to a snapshot node, nothing is copied or allocated.
+    // Offsets are read from the snapshot, so a node and its payload are checked against the snapshot size
+    // when the node is reached, a corrupt snapshot throws `ParserError` instead of reading past its end.
+    class SnapshotValue
+    {
+    public:
+        SnapshotValue() : m_base{nullptr}, m_size{0}, m_offset{0} {}
+
+        SnapshotValue(const char* base, std::uint64_t size, std::uint64_t offset)
+            : m_base{base}, m_size{size}, m_offset{offset}
+        {
+            if (offset < details::SnapshotHeaderSize || offset > size || size - offset < 8)
+                throw makeError(ParserError::Eof);
+
+            std::uint64_t payloadSize = 0;
+            switch (tag())
+            {
+            case details::SnapshotTag::Integer: case details::SnapshotTag::Double: case details::SnapshotTag::Unsigned:
+                payloadSize = 8;
+                break;
+            case details::SnapshotTag::String: payloadSize = std::uint64_t{nodeSize()} + 1; break;
+            case details::SnapshotTag::Array: payloadSize = std::uint64_t{nodeSize()} * 8; break;
+            case details::SnapshotTag::Object: payloadSize = std::uint64_t{nodeSize()} * 16; break;
+            default: break;
+            }
+
+            if (size - offset - 8 < payloadSize)
+                throw makeError(ParserError::Eof);
+
+            // `c_str()` relies on the terminating zero
+            if (tag() == details::SnapshotTag::String && m_base[offset + 8 + nodeSize()] != '\0')
+                throw makeError(ParserError::UnexpectedCharacter);
+        }
+
+        Type getType() const
+        {
+            switch (tag())
+            {
+            case details::SnapshotTag::Null: return Type::Null;
+            case details::SnapshotTag::Boolean: return Type::Boolean;
+            case details::SnapshotTag::Integer: return Type::Number;
+            case details::SnapshotTag::Unsigned: return Type::Number;
+            case details::SnapshotTag::Double: return Type::Number;
+            case details::SnapshotTag::String: return Type::String;
+            case details::SnapshotTag::Array: return Type::Array;
+            case details::SnapshotTag::Object: return Type::Object;
+            }
+
+            return Type::Undefined;
+        }
+
+        // True if the number was written from an integral type
+        bool isInteger() const { return tag() == details::SnapshotTag::Integer || tag() == details::SnapshotTag::Unsigned; }
+
+        bool getBoolean() const
+        {
+            checkTag(details::SnapshotTag::Boolean);
+            return nodeSize() != 0;
+        }
+
+        double getNumber() const
+        {
+            if (tag() == details::SnapshotTag::Integer)
+                return static_cast<double>(payload<std::int64_t>(0));
+
+            if (tag() == details::SnapshotTag::Unsigned)
+                return static_cast<double>(payload<std::uint64_t>(0));
+
+            checkTag(details::SnapshotTag::Double);
+            return payload<double>(0);
+        }
+
+        // Doubles are truncated, numbers out of the range of the type are `NumberIsOutOfRange`
+        std::int64_t getInteger() const
+        {
+            if (tag() == details::SnapshotTag::Unsigned)
+                throw makeError(ParserError::NumberIsOutOfRange);
+
+            if (tag() == details::SnapshotTag::Double)
+            {
+                auto value = payload<double>(0);
+                if (!(value > -9223372036854775809.0 && value < 9223372036854775808.0))
+                    throw makeError(ParserError::NumberIsOutOfRange);
+
+                return static_cast<std::int64_t>(value);
+            }
+
+            checkTag(details::SnapshotTag::Integer);
+            return payload<std::int64_t>(0);
+        }
+
+        std::uint64_t getUnsigned() const
+        {
+            if (tag() == details::SnapshotTag::Unsigned)
+                return payload<std::uint64_t>(0);
+
+            if (tag() == details::SnapshotTag::Double)
+            {
+                auto value = payload<double>(0);
+                if (!(value > -1.0 && value < 18446744073709551616.0))
+                    throw makeError(ParserError::NumberIsOutOfRange);
+
+                return static_cast<std::uint64_t>(value);
+            }
+
+            checkTag(details::SnapshotTag::Integer);
+            auto value = payload<std::int64_t>(0);
+            if (value < 0)
+                throw makeError(ParserError::NumberIsOutOfRange);
+
+            return static_cast<std::uint64_t>(value);
+        }
+
+        StringRef getString() const
+        {
+            checkTag(details::SnapshotTag::String);
+            return{m_base + m_offset + 8, nodeSize()};
+        }
+
+        const char* c_str() const { return getString().data; }
+
+        // Number of array elements or object fields
+        std::size_t size() const
+        {
+            if (tag() != details::SnapshotTag::Object)
+                checkTag(details::SnapshotTag::Array);
+
+            return nodeSize();
+        }
+
+        SnapshotValue operator[](std::size_t index) const
+        {
+            checkTag(details::SnapshotTag::Array);
+            checkIndex(index);
+            return child(index * 8);
+        }
+
+        StringRef fieldName(std::size_t index) const
+        {
+            checkTag(details::SnapshotTag::Object);
+            checkIndex(index);
+            return child(index * 16).getString();
+        }
+
+        SnapshotValue fieldValue(std::size_t index) const
+        {
+            checkTag(details::SnapshotTag::Object);
+            checkIndex(index);
+            return child(index * 16 + 8);
+        }
+
+        // Binary search over the sorted field names
+        bool findField(const char* name, std::size_t nameSize, SnapshotValue& value) const
+        {
+            checkTag(details::SnapshotTag::Object);
+
+            std::size_t first = 0, last = nodeSize();
+            while (first != last)
+            {
+                auto middle = first + (last - first) / 2;
+                auto key = child(middle * 16).getString();
+                auto cmp = details::compareNames(key.data, key.size, name, nameSize);
+                if (cmp == 0)
+                {
+                    value = child(middle * 16 + 8);
+                    return true;
+                }
+
+                if (cmp < 0)
+                    first = middle + 1;
+                else
+                    last = middle;
+            }
+
+            return false;
+        }
+
+        bool findField(const std::string& name, SnapshotValue& value) const
+        {
+            return findField(name.data(), name.size(), value);
+        }
+
+        SnapshotValue operator[](const std::string& name) const
+        {
+            SnapshotValue value;
+            if (!findField(name, value))
+                throw makeError(ParserError::UnknownField);
+
+            return value;
+        }
+
+    private:
+        details::SnapshotTag tag() const { return details::loadSnapshot<details::SnapshotTag>(m_base, m_offset); }
+        std::size_t nodeSize() const { return details::loadSnapshot<std::uint32_t>(m_base, m_offset + 4); }
+
+        template<typename T>
+        T payload(std::size_t offset) const { return details::loadSnapshot<T>(m_base, m_offset + 8 + offset); }
+
+        // The node which the payload refers to at `offset`
+        SnapshotValue child(std::size_t offset) const { return{m_base, m_size, payload<std::uint64_t>(offset)}; }
+
+        void checkTag(details::SnapshotTag expected) const
+        {
+            if (tag() != expected)
+                throw makeError(ParserError::UnexpectedType);
+        }
+
+        void checkIndex(std::size_t index) const
+        {
+            if (index >= nodeSize())
+                throw std::out_of_range("jsoncpp: snapshot index is out of range");
+        }
+
+        // Like the MessagePack parser, the column is the byte offset
+        ParserError makeError(ParserError::Type type) const
+        {
+            return ParserError{type, 1, static_cast<std::size_t>(m_offset)};
+        }
+
+        const char* m_base;
+        std::uint64_t m_size;
+        std::uint64_t m_offset;
+    };
+
+    // Snapshot in a buffer owned by the caller, e.g. a memory-mapped file.
+    // Values are loaded with `memcpy`, so the buffer does not have to be aligned.
+    class SnapshotView
+    {
+    public:
+        SnapshotView(const char* data, std::size_t size)
+            : m_data{data}, m_size{size}
+        {
+            if (size < details::SnapshotHeaderSize)
+                throw ParserError{ParserError::Eof, 1, size};
+
+            // Version 2 only added a node type, so version 1 snapshots are read as well
+            auto version = details::loadSnapshot<std::uint32_t>(data, 4);
+            if (details::loadSnapshot<std::uint32_t>(data, 0) != details::SnapshotMagic
+                || version < 1 || version > details::SnapshotVersion)
+                throw ParserError{ParserError::UnexpectedCharacter, 1, 0};
+
+            auto root = details::loadSnapshot<std::uint64_t>(data, 8);
+            auto snapshotSize = details::loadSnapshot<std::uint64_t>(data, 16);
+            if (snapshotSize > size)
+                throw ParserError{ParserError::Eof, 1, size};
+
+            m_root = SnapshotValue{data, snapshotSize, root};
+        }
+
+        const char* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        SnapshotValue root() const { return m_root; }
+
+    private:
+        const char* m_data;
+        std::size_t m_size;
+        SnapshotValue m_root;
+    };
+
+    template<class T>
+    inline std::string to_snapshot(const T& object)
+    {
+        std::string result;
+        Generator<details::SnapshotTraits<std::string>> stream{result};
+        serialize(stream, const_cast<T&>(object));
+        return result;
+    }
+}
@@ -0,0 +1,78 @@
+// JSON for C++ : memory-mapped snapshot file
+// Belongs to the public domain
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <json-cpp/snapshot.hpp>
+
+namespace jsoncpp
+{
+    namespace details
+    {
+        class FileMapping
+        {
+        public:
+            explicit FileMapping(const std::string& path)
+            {
+                auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    throw std::system_error(errno, std::generic_category(), "open");
+
+                struct stat info;
+                if (::fstat(fd, &info) != 0)
+                {
+                    auto error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "fstat");
+                }
+
+                m_size = static_cast<std::size_t>(info.st_size);
+                m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+                auto error = errno;
+                ::close(fd);
+
+                if (m_data == MAP_FAILED)
+                    throw std::system_error(error, std::generic_category(), "mmap");
+            }
+
+            FileMapping(const FileMapping&) = delete;
+            void operator=(const FileMapping&) = delete;
+
+            ~FileMapping() { ::munmap(m_data, m_size); }
+
+            const char* data() const { return static_cast<const char*>(m_data); }
+            std::size_t size() const { return m_size; }
+
+        private:
+            void* m_data;
+            std::size_t m_size;
+        };
+    }
+
+    // Read-only snapshot file, pages are loaded by the OS on first access
+    class MappedSnapshot
+    {
+    public:
+        explicit MappedSnapshot(const std::string& path)
+            : m_mapping{path}, m_view{m_mapping.data(), m_mapping.size()}
+        {
+        }
+
+        const SnapshotView& view() const { return m_view; }
+        SnapshotValue root() const { return m_view.root(); }
+
+    private:
+        details::FileMapping m_mapping;
+        SnapshotView m_view;
+    };
+}
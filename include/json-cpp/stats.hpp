@@ -0,0 +1,272 @@
+// JSON for C++ : parser and generator statistics
+// Belongs to the public domain
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+#if defined __GNUG__
+#   include <cxxabi.h>
+#endif
+
+#include <json-cpp/parse.hpp>
+#include <json-cpp/generate.hpp>
+#include <json-cpp/std_types.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/string_ref.hpp>
+
+namespace jsoncpp
+{
+    // Number of calls and total time, nested objects and fields are included
+    struct Profile
+    {
+        std::size_t count{0};
+        double seconds{0};
+    };
+
+    template<class X>
+    inline void serialize(Stream<X>& stream, Profile& o)
+    {
+        fields(o, stream, "count", o.count, "seconds", o.seconds);
+    }
+
+    // Counters are accumulated over all parse or generate calls the object is passed to
+    struct Stats
+    {
+        // Consumed by the parser or written by `to_string`
+        std::size_t bytes{0};
+
+        // Values by type
+        std::size_t nulls{0};
+        std::size_t booleans{0};
+        std::size_t numbers{0};
+        std::size_t strings{0};
+        std::size_t arrays{0};
+        std::size_t objects{0};
+
+        // Decoded or encoded strings, including field names, and their length in characters
+        std::size_t stringCount{0};
+        std::size_t stringLength{0};
+        std::size_t escapes{0};
+
+        std::size_t maxDepth{0};
+        std::size_t skippedValues{0};
+
+        // Times a string buffer had to grow while decoding
+        std::size_t allocations{0};
+
+        double seconds{0};
+
+        // Time spent in `fields()` by type name and by "type.field"
+        std::map<std::string, Profile> types;
+        std::map<std::string, Profile> fields;
+    };
+
+    template<class X>
+    inline void serialize(Stream<X>& stream, Stats& o)
+    {
+        fields(o, stream, "bytes", o.bytes, "nulls", o.nulls, "booleans", o.booleans, "numbers", o.numbers,
+            "strings", o.strings, "arrays", o.arrays, "objects", o.objects,
+            "stringCount", o.stringCount, "stringLength", o.stringLength, "escapes", o.escapes,
+            "maxDepth", o.maxDepth, "skippedValues", o.skippedValues, "allocations", o.allocations,
+            "seconds", o.seconds, "types", o.types, "fields", o.fields);
+    }
+
+    namespace details
+    {
+        inline std::string typeName(const std::type_info& type)
+        {
+#if defined __GNUG__
+            auto status = 0;
+            auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+            if (status == 0 && demangled != nullptr)
+            {
+                std::string result{demangled};
+                std::free(demangled);
+                return result;
+            }
+#endif
+            return type.name();
+        }
+
+        // Counts consumed characters and backslash escapes
+        template<typename Iterator>
+        class CountingIterator
+        {
+        public:
+            CountingIterator(Iterator iter, Stats* stats) : m_iter(iter), m_stats{stats} {}
+
+            auto operator*() -> decltype(*std::declval<Iterator&>()) { return *m_iter; }
+
+            CountingIterator& operator++()
+            {
+                if (m_isEscaped)
+                    m_isEscaped = false;
+                else if (*m_iter == '\\')
+                    m_isEscaped = true, ++m_stats->escapes;
+
+                ++m_stats->bytes;
+                ++m_iter;
+                return *this;
+            }
+
+            bool operator==(const CountingIterator& rhs) const { return m_iter == rhs.m_iter; }
+            bool operator!=(const CountingIterator& rhs) const { return !(*this == rhs); }
+
+        private:
+            Iterator m_iter;
+            Stats* m_stats;
+            bool m_isEscaped{false};
+        };
+    }
+
+    // Statistics policy which writes to a `Stats` object
+    class CollectStats
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit CollectStats(Stats& stats) : m_stats{&stats} {}
+
+        void value(Type type)
+        {
+            switch (type)
+            {
+            case Type::Null: ++m_stats->nulls; break;
+            case Type::Boolean: ++m_stats->booleans; break;
+            case Type::Number: ++m_stats->numbers; break;
+            case Type::String: ++m_stats->strings; break;
+            case Type::Array: ++m_stats->arrays; enterList(); break;
+            case Type::Object: ++m_stats->objects; enterList(); break;
+            case Type::Undefined: break;
+            }
+        }
+
+        void listEnd() { --m_depth; }
+
+        void parsedString(std::size_t length, bool grew)
+        {
+            ++m_stats->stringCount;
+            m_stats->stringLength += length;
+            if (grew)
+                ++m_stats->allocations;
+        }
+
+        void writtenString(const char* str)
+        {
+            writtenString(str, std::strlen(str));
+        }
+
+        template<typename CharT, class Traits, class Alloc>
+        void writtenString(const std::basic_string<CharT, Traits, Alloc>& str)
+        {
+            writtenString(str.data(), str.size());
+        }
+
+        void writtenString(const StringRef& str)
+        {
+            writtenString(str.data, str.size);
+        }
+
+        void skipped() { ++m_stats->skippedValues; }
+
+        Clock::time_point profileBegin() { return Clock::now(); }
+
+        void profileEnd(Clock::time_point start, const std::type_info& type, const char* field)
+        {
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+
+            auto it = m_typeNames.find(type);
+            if (it == m_typeNames.end())
+                it = m_typeNames.emplace(type, details::typeName(type)).first;
+
+            auto& profile = field == nullptr ? m_stats->types[it->second] : m_stats->fields[it->second + '.' + field];
+            ++profile.count;
+            profile.seconds += elapsed.count();
+        }
+
+    private:
+        void enterList()
+        {
+            if (++m_depth > m_stats->maxDepth)
+                m_stats->maxDepth = m_depth;
+        }
+
+        template<typename CharT>
+        void writtenString(const CharT* str, std::size_t size)
+        {
+            ++m_stats->stringCount;
+            m_stats->stringLength += size;
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                auto ch = static_cast<char32_t>(str[i]);
+                if (ch < 0x20 || ch == '"' || ch == '\\')
+                    ++m_stats->escapes;
+            }
+        }
+
+        Stats* m_stats;
+        std::size_t m_depth{0};
+        std::unordered_map<std::type_index, std::string> m_typeNames;
+    };
+
+    template<typename CharT, class T, typename InputIterator>
+    inline void parse(T& object, InputIterator first, InputIterator last, Stats& stats)
+    {
+        using Iterator = details::CountingIterator<InputIterator>;
+
+        auto start = CollectStats::Clock::now();
+        Parser<details::Traits2<CharT, Iterator, CollectStats>> stream{{first, &stats}, {last, &stats}, CollectStats{stats}};
+        serialize(stream, object);
+
+        std::chrono::duration<double> elapsed = CollectStats::Clock::now() - start;
+        stats.seconds += elapsed.count();
+    }
+
+    template<typename T, typename CharT>
+    inline void parse(T& object, const CharT* str, Stats& stats)
+    {
+        details::CStrIterator<CharT> first{str}, last;
+        parse<CharT>(object, first, last, stats);
+    }
+
+    template<typename T, typename CharT>
+    inline void parse(T& object, const std::basic_string<CharT>& str, Stats& stats)
+    {
+        parse<CharT>(object, std::begin(str), std::end(str), stats);
+    }
+
+    template<typename T, typename CharT>
+    inline void parse(T& object, std::basic_istream<CharT>& stream, Stats& stats)
+    {
+        std::istreambuf_iterator<CharT> first{stream}, last;
+        parse<CharT>(object, first, last, stats);
+    }
+
+    template<class T>
+    inline std::string to_string(const T& object, Stats& stats)
+    {
+        auto start = CollectStats::Clock::now();
+
+        std::ostringstream rawStream;
+        Generator<details::Traits2<char, std::ostream, CollectStats>> stream{rawStream, CollectStats{stats}};
+        serialize(stream, const_cast<T&>(object));
+        auto result = rawStream.str();
+
+        std::chrono::duration<double> elapsed = CollectStats::Clock::now() - start;
+        stats.seconds += elapsed.count();
+        stats.bytes += result.size();
+        return result;
+    }
+}
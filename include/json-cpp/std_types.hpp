@@ -3,19 +3,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <deque>
 #include <forward_list>
+#include <iterator>
 #include <list>
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <json-cpp/parse.hpp>
 #include <json-cpp/generate.hpp>
+#include <json-cpp/fixed_string.hpp>
+#include <json-cpp/string_ref.hpp>
+#include <json-cpp/details/number_parser.hpp>
+#include <json-cpp/details/number_writer.hpp>
 
 namespace jsoncpp
 {
@@ -44,7 +55,8 @@ namespace jsoncpp
     {
         if (parser.getType() != jsoncpp::Type::Null)
         {
-            obj->reset(new T());
+            if (!obj || !details::updatesInPlace(parser))
+                obj.reset(new T());
             serialize(parser, *obj);
         }
         else
@@ -61,10 +73,85 @@ namespace jsoncpp
 
     namespace details
     {
+        // Only containers with `reserve` are pre-sized, a `deque` allocates in blocks anyway.
+        // Hash tables aren't rehashed if they are large enough already, it would allocate.
+        template<typename C>
+        inline void reserveItems(C&, std::size_t)
+        {
+        }
+
+        template<typename T, class Alloc>
+        inline void reserveItems(std::vector<T, Alloc>& c, std::size_t size)
+        {
+            c.reserve(size);
+        }
+
+        template<typename Key, typename T, class Hash, class Pred, class Alloc>
+        inline void reserveItems(std::unordered_map<Key, T, Hash, Pred, Alloc>& c, std::size_t size)
+        {
+            if (size > c.bucket_count() * c.max_load_factor())
+                c.reserve(size);
+        }
+
+        template<typename T, class Hash, class Pred, class Alloc>
+        inline void reserveItems(std::unordered_set<T, Hash, Pred, Alloc>& c, std::size_t size)
+        {
+            if (size > c.bucket_count() * c.max_load_factor())
+                c.reserve(size);
+        }
+
+        // Items which are parsed before they are inserted get the allocator of the container,
+        // so moving them into it doesn't copy
+        template<typename C>
+        inline typename std::enable_if<!std::uses_allocator<typename C::value_type, typename C::allocator_type>::value,
+            typename C::value_type>::type makeItem(C&)
+        {
+            return typename C::value_type();
+        }
+
+        template<typename C>
+        inline typename std::enable_if<std::uses_allocator<typename C::value_type, typename C::allocator_type>::value,
+            typename C::value_type>::type makeItem(C& c)
+        {
+            return typename C::value_type(c.get_allocator());
+        }
+
+        // Existing elements are parsed in place, the rest is appended, and the elements left over are erased
+        template<class X, typename C>
+        inline void updateContainer(Parser<X>& parser, C& c)
+        {
+            reserveItems(c, parser.listSizeHint());
+
+            auto iter = c.begin();
+            parseArray(parser, [&]
+            {
+                if (iter != c.end())
+                {
+                    serialize(parser, *iter);
+                    ++iter;
+                }
+                else
+                {
+                    c.emplace_back();
+                    serialize(parser, c.back());
+                    iter = c.end();
+                }
+            });
+
+            c.erase(iter, c.end());
+        }
+
         template<class X, typename C>
         inline void serializeContainer(Parser<X>& parser, C& c)
         {
+            if (updatesInPlace(parser))
+            {
+                updateContainer(parser, c);
+                return;
+            }
+
             c.clear();
+            reserveItems(c, parser.listSizeHint());
 
             parseArray(parser, [&]
             {
@@ -79,16 +166,153 @@ namespace jsoncpp
             writeRange(generator, c);
         }
 
+        template<typename T>
+        struct IsCharacter
+        {
+            static const bool value = std::is_same<T, char>::value || std::is_same<T, signed char>::value
+                || std::is_same<T, unsigned char>::value || std::is_same<T, wchar_t>::value
+                || std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value;
+        };
+
+        // Arithmetic types which are numbers, i.e. not `bool` and not character types.
+        // Vectors of them are numeric arrays, and integral ones are integer map keys.
+        template<typename T>
+        struct IsNumber
+        {
+            static const bool value = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && !IsCharacter<T>::value;
+        };
+
+        template<typename CharT, typename Iterator, class StatsPolicy, typename T, class Alloc>
+        inline typename std::enable_if<IsNumber<T>::value>::type
+            serializeContainer(Parser<Traits2<CharT, Iterator, StatsPolicy>>& parser, std::vector<T, Alloc>& c)
+        {
+            parser.parseNumberArray(c);
+        }
+
+        template<typename CharT, typename Sink, class StatsPolicy, typename T, class Alloc>
+        inline typename std::enable_if<IsNumber<T>::value>::type
+            serializeContainer(Generator<Traits2<CharT, Sink, StatsPolicy>>& generator, std::vector<T, Alloc>& c)
+        {
+            generator.writeNumberArray(c.data(), c.size());
+        }
+
+        // Fixed-size arrays take exactly as many items as they have, they are parsed in place
+        template<class X, typename T>
+        inline void serializeFixedArray(Parser<X>& parser, T* items, std::size_t size)
+        {
+            std::size_t i = 0;
+            parseArray(parser, [&]
+            {
+                if (i == size)
+                    throw parser.makeError(ParserError::WrongArraySize);
+                serialize(parser, items[i++]);
+            });
+
+            if (i != size)
+                throw parser.makeError(ParserError::WrongArraySize);
+        }
+
+        template<class X, typename T>
+        inline void serializeFixedArray(Generator<X>& generator, T* items, std::size_t size)
+        {
+            struct Range
+            {
+                T* begin() const { return first; }
+                T* end() const { return last; }
+                T* first;
+                T* last;
+            };
+
+            Range range{items, items + size};
+            writeRange(generator, range);
+        }
+
+        template<typename CharT, typename Sink, class StatsPolicy, typename T>
+        inline typename std::enable_if<IsNumber<T>::value>::type
+            serializeFixedArray(Generator<Traits2<CharT, Sink, StatsPolicy>>& generator, T* items, std::size_t size)
+        {
+            generator.writeNumberArray(items, size);
+        }
+
+        // A character array is a null-terminated string, it's parsed without allocation
+        template<class X, std::size_t N>
+        inline void serializeCharArray(Parser<X>& parser, char (&str)[N])
+        {
+            FixedString<N - 1> value;
+            serialize(parser, value);
+            std::copy(value.c_str(), value.c_str() + value.size() + 1, str);
+        }
+
+        template<class X, std::size_t N>
+        inline void serializeCharArray(Generator<X>& generator, char (&str)[N])
+        {
+            StringRef value{str, static_cast<std::size_t>(std::find(str, str + N, '\0') - str)};
+            serialize(generator, value);
+        }
+
+        // Tuples and pairs are arrays of a fixed size, the item index is mapped to the element at run time
+        template<std::size_t I, class X, typename Tuple>
+        inline typename std::enable_if<I == std::tuple_size<Tuple>::value>::type
+            parseTupleItem(Parser<X>& parser, Tuple&, std::size_t)
+        {
+            throw parser.makeError(ParserError::WrongArraySize);
+        }
+
+        template<std::size_t I, class X, typename Tuple>
+        inline typename std::enable_if<(I < std::tuple_size<Tuple>::value)>::type
+            parseTupleItem(Parser<X>& parser, Tuple& t, std::size_t index)
+        {
+            if (index == I)
+                serialize(parser, std::get<I>(t));
+            else
+                parseTupleItem<I + 1>(parser, t, index);
+        }
+
+        template<class X, typename Tuple>
+        inline void serializeTuple(Parser<X>& parser, Tuple& t)
+        {
+            std::size_t i = 0;
+            parseArray(parser, [&] { parseTupleItem<0>(parser, t, i++); });
+
+            if (i != std::tuple_size<Tuple>::value)
+                throw parser.makeError(ParserError::WrongArraySize);
+        }
+
+        template<std::size_t I, class X, typename Tuple>
+        inline typename std::enable_if<I == std::tuple_size<Tuple>::value>::type
+            writeTupleItems(Generator<X>&, Tuple&)
+        {
+        }
+
+        template<std::size_t I, class X, typename Tuple>
+        inline typename std::enable_if<(I < std::tuple_size<Tuple>::value)>::type
+            writeTupleItems(Generator<X>& generator, Tuple& t)
+        {
+            if (I != 0)
+                generator.separator();
+            serialize(generator, std::get<I>(t));
+            writeTupleItems<I + 1>(generator, t);
+        }
+
+        template<class X, typename Tuple>
+        inline void serializeTuple(Generator<X>& generator, Tuple& t)
+        {
+            generator.arrayBegin();
+            writeTupleItems<0>(generator, t);
+            generator.arrayEnd();
+        }
+
         template<class X, typename C>
         inline void serializeSet(Parser<X>& parser, C& c)
         {
             c.clear();
+            reserveItems(c, parser.listSizeHint());
 
             parseArray(parser, [&]
             {
-                typename C::value_type value;
+                auto value = makeItem(c);
                 serialize(parser, value);
-                c.insert(value);
+                c.emplace_hint(c.end(), std::move(value));
             });
         }
 
@@ -98,19 +322,98 @@ namespace jsoncpp
             writeRange(generator, c);
         }
 
+        // Integer keys are written as strings of decimal digits
+        template<typename Key>
+        struct IsIntegerKey
+        {
+            static const bool value = std::is_integral<Key>::value && IsNumber<Key>::value;
+        };
+
+        template<typename Key>
+        struct IsStringKey : std::false_type {};
+
+        template<class Traits, class Alloc>
+        struct IsStringKey<std::basic_string<char, Traits, Alloc>> : std::true_type {};
+
+        template<typename Key>
+        struct IsMapKey
+        {
+            static const bool value = IsStringKey<Key>::value || IsIntegerKey<Key>::value;
+        };
+
+        template<typename Key, class X, typename C>
+        inline typename std::enable_if<std::is_same<Key, std::string>::value, const std::string&>::type
+            parseMapKey(Parser<X>&, C&, const std::string& name)
+        {
+            return name;
+        }
+
+        // Keys with another allocator are created with the allocator of the map
+        template<typename Key, class X, typename C>
+        inline typename std::enable_if<IsStringKey<Key>::value && !std::is_same<Key, std::string>::value, Key>::type
+            parseMapKey(Parser<X>&, C& c, const std::string& name)
+        {
+            return Key(name.data(), name.size(), typename Key::allocator_type(c.get_allocator()));
+        }
+
+        template<typename Key, class X, typename C>
+        inline typename std::enable_if<IsIntegerKey<Key>::value, Key>::type
+            parseMapKey(Parser<X>& parser, C&, const std::string& name)
+        {
+            Key key;
+            auto err = parseIntegerKey(name.data(), name.data() + name.size(), key);
+            if (err != ParserError::NoError)
+                throw parser.makeError(err);
+            return key;
+        }
+
+        template<class X, class Traits, class Alloc>
+        inline void writeMapKey(Generator<X>& generator, const std::basic_string<char, Traits, Alloc>& key)
+        {
+            generator.fieldName(key);
+        }
+
+        // The name is in a temporary buffer, so it's passed with its size, `const char*` names are literals
+        template<class X, typename Key>
+        inline typename std::enable_if<IsIntegerKey<Key>::value>::type writeMapKey(Generator<X>& generator, Key key)
+        {
+            char buf[MaxNumberLength];
+            generator.fieldName(StringRef{buf, formatNumber(buf, key)});
+        }
+
+        template<typename C, typename Key>
+        inline typename C::mapped_type& findOrInsert(C& c, Key&& key)
+        {
+            return c[std::forward<Key>(key)];
+        }
+
+        // Keys usually arrive sorted, then a new item is appended at the end in constant time
+        template<typename Key, typename T, class Compare, class Alloc, typename K>
+        inline T& findOrInsert(std::map<Key, T, Compare, Alloc>& c, K&& key)
+        {
+            if (!c.empty() && !c.key_comp()(std::prev(c.end())->first, key))
+                return c[std::forward<K>(key)];
+
+            return c.emplace_hint(c.end(), std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple())->second;
+        }
+
         template<class X, typename C>
-        inline void serializeStrMap(Parser<X>& parser, C& c)
+        inline void serializeMap(Parser<X>& parser, C& c)
         {
-            c.clear();
+            // Values of the keys in the input are parsed in place then
+            if (!updatesInPlace(parser))
+                c.clear();
+            reserveItems(c, parser.listSizeHint());
 
             parseObject(parser, [&](const std::string& name)
             {
-                serialize(parser, c[name]);
+                serialize(parser, findOrInsert(c, parseMapKey<typename C::key_type>(parser, c, name)));
             });
         }
 
         template<class X, typename C>
-        inline void serializeStrMap(Generator<X>& generator, C& c)
+        inline void serializeMap(Generator<X>& generator, C& c)
         {
             generator.objectBegin();
             
@@ -120,7 +423,7 @@ namespace jsoncpp
             {
                 for (;;)
                 {
-                    generator.fieldName(iter->first);
+                    writeMapKey(generator, iter->first);
                     serialize(generator, iter->second);
 
                     ++iter;
@@ -135,35 +438,55 @@ namespace jsoncpp
         }
     }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::vector<T>& arr)
+    template<class X, typename T, class Alloc>
+    inline void serialize(Stream<X>& stream, std::vector<T, Alloc>& arr)
     { details::serializeContainer(stream, arr); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::list<T>& arr)
+    template<class X, typename T, class Alloc>
+    inline void serialize(Stream<X>& stream, std::list<T, Alloc>& arr)
     { details::serializeContainer(stream, arr); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::forward_list<T>& arr)
+    template<class X, typename T, class Alloc>
+    inline void serialize(Stream<X>& stream, std::forward_list<T, Alloc>& arr)
     { details::serializeContainer(stream, arr); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::deque<T>& arr)
+    template<class X, typename T, class Alloc>
+    inline void serialize(Stream<X>& stream, std::deque<T, Alloc>& arr)
     { details::serializeContainer(stream, arr); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::set<T>& arr)
+    template<class X, typename T, std::size_t N>
+    inline void serialize(Stream<X>& stream, std::array<T, N>& arr)
+    { details::serializeFixedArray(stream, arr.data(), N); }
+
+    template<class X, typename T, std::size_t N>
+    inline void serialize(Stream<X>& stream, T (&arr)[N])
+    { details::serializeFixedArray(stream, arr, N); }
+
+    template<class X, std::size_t N>
+    inline void serialize(Stream<X>& stream, char (&str)[N])
+    { details::serializeCharArray(stream, str); }
+
+    template<class X, typename... Ts>
+    inline void serialize(Stream<X>& stream, std::tuple<Ts...>& t)
+    { details::serializeTuple(stream, t); }
+
+    template<class X, typename T1, typename T2>
+    inline void serialize(Stream<X>& stream, std::pair<T1, T2>& p)
+    { details::serializeTuple(stream, p); }
+
+    template<class X, typename T, class Compare, class Alloc>
+    inline void serialize(Stream<X>& stream, std::set<T, Compare, Alloc>& arr)
     { details::serializeSet(stream, arr); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::unordered_set<T>& arr)
+    template<class X, typename T, class Hash, class Pred, class Alloc>
+    inline void serialize(Stream<X>& stream, std::unordered_set<T, Hash, Pred, Alloc>& arr)
     { details::serializeSet(stream, arr); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::map<std::string, T>& t)
-    { details::serializeStrMap(stream, t); }
+    template<class X, typename Key, typename T, class Compare, class Alloc>
+    inline typename std::enable_if<details::IsMapKey<Key>::value>::type serialize(Stream<X>& stream, std::map<Key, T, Compare, Alloc>& t)
+    { details::serializeMap(stream, t); }
 
-    template<class X, typename T>
-    inline void serialize(Stream<X>& stream, std::unordered_map<std::string, T>& t)
-    { details::serializeStrMap(stream, t); }
+    template<class X, typename Key, typename T, class Hash, class Pred, class Alloc>
+    inline typename std::enable_if<details::IsMapKey<Key>::value>::type serialize(Stream<X>& stream, std::unordered_map<Key, T, Hash, Pred, Alloc>& t)
+    { details::serializeMap(stream, t); }
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+// JSON for C++ : non-owning string
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace jsoncpp
+{
+    // A string which points into a buffer owned by someone else, no copy is made
+    struct StringRef
+    {
+        const char* data;
+        std::size_t size;
+
+        std::string str() const { return{data, size}; }
+    };
+}
@@ -0,0 +1,113 @@
+// JSON for C++ : allocation counting for tests
+// Belongs to the public domain
+
+#include "alloc_counter.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // Thread-local, so tests running other threads don't disturb the counts
+    thread_local std::size_t allocations;
+    thread_local std::size_t bytes;
+    thread_local long long liveBytes;
+    thread_local long long peakBytes;
+
+    // The size of each block is stored in front of it, so unsized `operator delete` knows it
+    const std::size_t HeaderSize = alignof(std::max_align_t) > sizeof(std::size_t) ? alignof(std::max_align_t) : sizeof(std::size_t);
+
+    void* allocate(std::size_t size)
+    {
+        auto block = static_cast<char*>(std::malloc(HeaderSize + size));
+        if (block == nullptr)
+            return nullptr;
+
+        *reinterpret_cast<std::size_t*>(block) = size;
+        ++allocations;
+        bytes += size;
+        liveBytes += static_cast<long long>(size);
+        if (liveBytes > peakBytes)
+            peakBytes = liveBytes;
+
+        return block + HeaderSize;
+    }
+
+    void deallocate(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        auto block = static_cast<char*>(ptr) - HeaderSize;
+        liveBytes -= static_cast<long long>(*reinterpret_cast<std::size_t*>(block));
+        std::free(block);
+    }
+}
+
+namespace alloc_counter
+{
+    Counts current()
+    {
+        return Counts{allocations, bytes, liveBytes};
+    }
+
+    long long resetPeak()
+    {
+        auto peak = peakBytes;
+        peakBytes = liveBytes;
+        return peak;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    if (auto ptr = allocate(size))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
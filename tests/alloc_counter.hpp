@@ -0,0 +1,43 @@
+// JSON for C++ : allocation counting for tests
+// Belongs to the public domain
+
+#pragma once
+
+#include <cstddef>
+
+namespace alloc_counter
+{
+    // Calls of the global `operator new` made by the current thread, and its heap bytes which are live,
+    // i.e. allocated and not freed yet, blocks freed by other threads are subtracted there
+    struct Counts
+    {
+        std::size_t allocations;
+        std::size_t bytes;
+        long long liveBytes;
+    };
+
+    Counts current();
+
+    // Starts tracking the peak of live bytes from the current value, returns the peak since the last reset
+    long long resetPeak();
+
+    struct Usage
+    {
+        std::size_t allocations;
+        std::size_t bytes;
+        std::size_t peakBytes;  // the peak of live heap bytes during the call, above the bytes live before it
+    };
+
+    // Allocations made by `fn`, and its peak heap usage
+    template<typename Fn>
+    inline Usage measure(Fn&& fn)
+    {
+        auto before = current();
+        resetPeak();
+        fn();
+        auto peak = resetPeak();
+        auto after = current();
+        return Usage{after.allocations - before.allocations, after.bytes - before.bytes,
+            static_cast<std::size_t>(peak - before.liveBytes)};
+    }
+}
@@ -0,0 +1,254 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+#include "alloc_counter.hpp"
+
+#include <json-cpp.hpp>
+#include <json-cpp/interned_string.hpp>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined _WIN32
+#   include <json-cpp/file_sink.hpp>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+namespace
+{
+    struct Order
+    {
+        int id;
+        double price;
+        bool paid;
+        std::string customer;
+        std::vector<int> items;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Order& o)
+    {
+        fields(o, stream, "id", o.id, "price", o.price, "paid", o.paid, "customer", o.customer, "items", o.items);
+    }
+
+    const char* const Text = R"({"id": 42, "price": 12.5, "paid": true, "customer": "A customer with a long name", "items": [1, 2, 3, 4, 5, 6, 7, 8]})";
+
+    Order presized()
+    {
+        Order order{};
+        order.customer.reserve(64);
+        order.items.reserve(16);
+        return order;
+    }
+}
+
+TEST_CASE("Allocations are counted", "[alloc]")
+{
+    auto usage = alloc_counter::measure([] { std::vector<int> v(100); });
+    CHECK(usage.allocations == 1);
+    CHECK(usage.bytes == 100 * sizeof(int));
+
+    usage = alloc_counter::measure([] {});
+    CHECK(usage.allocations == 0);
+    CHECK(usage.bytes == 0);
+}
+
+TEST_CASE("Parsing into a pre-sized struct doesn't allocate", "[alloc][parser]")
+{
+    auto order = presized();
+    std::string text = Text;
+
+    // The first call for each input type builds the static table of field names
+    jsoncpp::parse(order, Text);
+    jsoncpp::parse(order, text);
+
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(order, Text); });
+    CHECK(usage.allocations == 0);
+
+    usage = alloc_counter::measure([&] { jsoncpp::parse(order, text); });
+    CHECK(usage.allocations == 0);
+
+    CHECK(order.customer == "A customer with a long name");
+    CHECK(order.items.size() == 8);
+}
+
+TEST_CASE("Parsing allocates only for the growing containers", "[alloc][parser]")
+{
+    auto order = presized();
+    jsoncpp::parse(order, Text);
+
+    Order empty{};
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(empty, Text); });
+    CHECK(usage.allocations > 0);
+    CHECK(usage.allocations <= 10);
+    CHECK(usage.bytes < 1024);
+}
+
+TEST_CASE("Containers are allocated once for contiguous input", "[alloc][parser]")
+{
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> map;
+    for (auto i = 0; i != 1000; ++i)
+    {
+        names.push_back("name" + std::to_string(i));
+        map[names.back()] = i;
+    }
+    auto arrayText = jsoncpp::to_string(names);
+    auto objectText = jsoncpp::to_string(map);
+
+    jsoncpp::ParserOptions options;
+    options.reserveContainers = true;
+
+    // Short strings don't allocate, so it's only the vector
+    std::vector<std::string> parsedNames;
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(parsedNames, arrayText, options); });
+    CHECK(usage.allocations == 1);
+    CHECK(parsedNames == names);
+
+    // The nodes and the bucket array, which isn't rehashed
+    std::unordered_map<std::string, int> parsedMap;
+    usage = alloc_counter::measure([&] { jsoncpp::parse(parsedMap, objectText, options); });
+    CHECK(usage.allocations == map.size() + 1);
+    CHECK(parsedMap == map);
+
+    options.reserveContainers = false;
+    parsedNames.clear();
+    parsedNames.shrink_to_fit();
+    usage = alloc_counter::measure([&] { jsoncpp::parse(parsedNames, arrayText, options); });
+    CHECK(usage.allocations > 1);
+    CHECK(parsedNames == names);
+}
+
+TEST_CASE("Parsing in place doesn't allocate after warm-up", "[alloc][parser]")
+{
+    auto order = presized();
+    jsoncpp::parse(order, Text);
+    std::vector<Order> orders(100, order);
+    // Field names longer than the small string buffer would take one allocation per call
+    std::unordered_map<std::string, Order> byName;
+    for (auto i = 0; i != 100; ++i)
+        byName["order " + std::to_string(i)] = order;
+
+    auto ordersText = jsoncpp::to_string(orders);
+    auto byNameText = jsoncpp::to_string(byName);
+
+    jsoncpp::ParserOptions options;
+    options.updateInPlace = true;
+
+    std::vector<Order> parsedOrders;
+    std::unordered_map<std::string, Order> parsedByName;
+    jsoncpp::parse(parsedOrders, ordersText, options);
+    jsoncpp::parse(parsedByName, byNameText, options);
+
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(parsedOrders, ordersText, options); });
+    CHECK(usage.allocations == 0);
+    CHECK(parsedOrders.size() == orders.size());
+    CHECK(parsedOrders.back().customer == order.customer);
+
+    usage = alloc_counter::measure([&] { jsoncpp::parse(parsedByName, byNameText, options); });
+    CHECK(usage.allocations == 0);
+    CHECK(parsedByName.size() == byName.size());
+
+    // Clearing destroys the strings and vectors of the elements
+    usage = alloc_counter::measure([&] { jsoncpp::parse(parsedOrders, ordersText); });
+    CHECK(usage.allocations > orders.size());
+}
+
+namespace
+{
+    struct Quote
+    {
+        jsoncpp::FixedString<8> symbol;
+        char venue[16];
+        std::array<double, 4> levels;
+        std::pair<long long, int> stamp;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Quote& o)
+    {
+        fields(o, stream, "symbol", o.symbol, "venue", o.venue, "levels", o.levels, "stamp", o.stamp);
+    }
+}
+
+TEST_CASE("Parsing into fixed-size types doesn't allocate", "[alloc][parser]")
+{
+    const std::string text = R"({"symbol": "ACME", "venue": "a long venue", "levels": [1.5, 2, 2.5, 3], "stamp": [1700000000, 7]})";
+
+    // The first call builds the static table of field names
+    Quote quote{};
+    jsoncpp::parse(quote, text);
+
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(quote, text); });
+    CHECK(usage.allocations == 0);
+    CHECK(quote.symbol == "ACME");
+    CHECK(std::string{quote.venue} == "a long venue");
+    CHECK(quote.levels[3] == 3);
+    CHECK(quote.stamp.second == 7);
+
+    CHECK(jsoncpp::to_string(quote) == text);
+}
+
+TEST_CASE("Interned strings allocate only for new values", "[alloc][parser]")
+{
+    std::string text = "[";
+    for (auto i = 0; i != 1000; ++i)
+        text += i % 3 == 0 ? R"("an event type which doesn't fit in a small buffer", )" : R"("ok", )";
+    text += R"("done"])";
+
+    std::vector<jsoncpp::InternedString> events;
+    events.reserve(1001);
+    jsoncpp::parse(events, text);
+
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(events, text); });
+    CHECK(usage.allocations == 0);
+    CHECK(events.size() == 1001);
+    CHECK(events[0].data() == events[3].data());
+    CHECK(jsoncpp::to_string(events) == text);
+}
+
+#if !defined _WIN32
+TEST_CASE("Generating into a file sink doesn't allocate", "[alloc][gen]")
+{
+    auto order = presized();
+    jsoncpp::parse(order, Text);
+
+    auto fd = open("/dev/null", O_WRONLY);
+    REQUIRE(fd != -1);
+    {
+        jsoncpp::FileSink sink{fd};
+        jsoncpp::Generator<jsoncpp::details::Traits2<char, jsoncpp::FileSink>> stream{sink};
+        serialize(stream, order);
+
+        auto usage = alloc_counter::measure([&] { serialize(stream, order); sink.flush(); });
+        CHECK(usage.allocations == 0);
+    }
+    close(fd);
+}
+
+TEST_CASE("Peak memory is reported", "[alloc]")
+{
+    auto order = presized();
+    jsoncpp::parse(order, Text);
+    std::vector<Order> orders(1000, order);
+    auto text = jsoncpp::to_string(orders);
+
+    std::vector<Order> parsed;
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(parsed, text); });
+    CHECK(usage.allocations >= orders.size());
+    CHECK(usage.peakBytes >= orders.size() * sizeof(Order));
+    CHECK(usage.peakBytes <= usage.bytes);
+
+    // Memory freed inside the call counts only while it's live
+    usage = alloc_counter::measure([] { for (auto i = 0; i != 10; ++i) std::vector<char> v(1000); });
+    CHECK(usage.bytes == 10000);
+    CHECK(usage.peakBytes == 1000);
+
+    usage = alloc_counter::measure([] {});
+    CHECK(usage.peakBytes == 0);
+}
+#endif
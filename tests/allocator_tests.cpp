@@ -0,0 +1,160 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+#include "alloc_counter.hpp"
+
+#include <json-cpp.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <scoped_allocator>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined __has_include
+#   if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#       include <memory_resource>
+#   endif
+#endif
+
+namespace
+{
+    // Counts the allocations of all containers which share it, like a per-request arena
+    struct Arena
+    {
+        std::size_t allocations;
+    };
+
+    template<typename T>
+    struct ArenaAllocator
+    {
+        using value_type = T;
+
+        explicit ArenaAllocator(Arena& arena) : arena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+        T* allocate(std::size_t n)
+        {
+            ++arena->allocations;
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t) { ::operator delete(p); }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+        Arena* arena;
+    };
+
+    using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+    // The scoped adaptor passes the allocator of the container to its elements
+    template<typename T>
+    using ScopedAllocator = std::scoped_allocator_adaptor<ArenaAllocator<T>>;
+}
+
+TEST_CASE("Parsing into containers with custom allocators", "[parser][alloc]")
+{
+    Arena arena{0};
+    const auto text = std::string{R"(["a string which doesn't fit in a small buffer", "b"])"};
+
+    jsoncpp::ParserOptions options;
+    options.reserveContainers = true;
+    std::vector<ArenaString, ScopedAllocator<ArenaString>> strings{ScopedAllocator<ArenaString>{arena}};
+    jsoncpp::parse(strings, text, options);
+    REQUIRE(strings.size() == 2);
+    REQUIRE(strings[0] == "a string which doesn't fit in a small buffer");
+    REQUIRE(strings[0].get_allocator().arena == &arena);
+
+    // The vector and the long string
+    REQUIRE(arena.allocations == 2);
+    REQUIRE(jsoncpp::to_string(strings) == text);
+
+    arena.allocations = 0;
+    std::set<ArenaString, std::less<ArenaString>, ScopedAllocator<ArenaString>> set{ScopedAllocator<ArenaString>{arena}};
+    jsoncpp::parse(set, text);
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.begin()->get_allocator().arena == &arena);
+    REQUIRE(arena.allocations == 3);
+
+    using Map = std::map<ArenaString, std::vector<int, ArenaAllocator<int>>, std::less<ArenaString>,
+        ScopedAllocator<std::pair<const ArenaString, std::vector<int, ArenaAllocator<int>>>>>;
+    Map map{Map::allocator_type{arena}};
+    jsoncpp::parse(map, R"({"a key which doesn't fit in a small buffer": [1, 2], "b": [3]})");
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.begin()->first.get_allocator().arena == &arena);
+    REQUIRE(map.begin()->second.get_allocator().arena == &arena);
+    REQUIRE(map.rbegin()->second.at(0) == 3);
+    REQUIRE(jsoncpp::to_string(map) == R"({"a key which doesn't fit in a small buffer": [1, 2], "b": [3]})");
+}
+
+#if defined __cpp_lib_memory_resource
+namespace
+{
+    // Allocator-aware, so the containers pass their memory resource to it
+    struct Request
+    {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        explicit Request(const allocator_type& alloc = {}) : name(alloc), tags(alloc), scores(alloc) {}
+
+        Request(const Request& other, const allocator_type& alloc)
+            : name(other.name, alloc), tags(other.tags, alloc), scores(other.scores, alloc) {}
+
+        Request(Request&& other, const allocator_type& alloc)
+            : name(std::move(other.name), alloc), tags(std::move(other.tags), alloc), scores(std::move(other.scores), alloc) {}
+
+        std::pmr::string name;
+        std::pmr::vector<std::pmr::string> tags;
+        std::pmr::unordered_map<std::pmr::string, double> scores;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Request& o)
+    {
+        fields(o, stream, "name", o.name, "tags", o.tags, "scores", o.scores);
+    }
+}
+
+TEST_CASE("Parsing into pmr containers with an arena", "[parser][alloc]")
+{
+    const auto text = std::string{R"([
+        {"name": "the first request has a long name", "tags": ["a tag which doesn't fit in a small buffer"],
+         "scores": {"a": 1.5, "b": 2}},
+        {"name": "x", "tags": [], "scores": {}}])"};
+
+    // The first call builds the static table of field names
+    std::pmr::vector<Request> warmUp;
+    jsoncpp::parse(warmUp, text);
+
+    // Everything comes from the buffer, the upstream resource would throw.
+    // Field names longer than the small string buffer would take one allocation of the parser.
+    alignas(std::max_align_t) char buffer[16 << 10];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+    std::pmr::vector<Request> requests{&arena};
+
+    auto usage = alloc_counter::measure([&] { jsoncpp::parse(requests, text); });
+    CHECK(usage.allocations == 0);
+
+    REQUIRE(requests.size() == 2);
+    REQUIRE(requests[0].name == "the first request has a long name");
+    REQUIRE(requests[0].tags.at(0) == "a tag which doesn't fit in a small buffer");
+    REQUIRE(requests[0].scores.at("a") == 1.5);
+    REQUIRE(requests[0].tags.get_allocator().resource() == &arena);
+    REQUIRE(requests[1].name == "x");
+
+    std::pmr::set<std::pmr::string> set{&arena};
+    jsoncpp::parse(set, std::string{R"(["a string which doesn't fit in a small buffer"])"});
+    REQUIRE(set.begin()->get_allocator().resource() == &arena);
+}
+#endif
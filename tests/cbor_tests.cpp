@@ -0,0 +1,187 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/cbor.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/std_types.hpp>
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string hex(const std::string& bytes)
+    {
+        const auto table = "0123456789abcdef";
+        std::string result;
+        for (auto ch : bytes)
+        {
+            auto n = static_cast<unsigned char>(ch);
+            result.push_back(table[n >> 4]);
+            result.push_back(table[n & 15]);
+        }
+        return result;
+    }
+
+    std::string unhex(const std::string& str)
+    {
+        std::string result;
+        for (std::size_t i = 0; i + 1 < str.size(); i += 2)
+            result.push_back(static_cast<char>(std::stoi(str.substr(i, 2), nullptr, 16)));
+        return result;
+    }
+
+    template<typename T>
+    std::string encode(T value)
+    {
+        return hex(jsoncpp::to_cbor(value));
+    }
+
+    template<typename T>
+    T decode(const std::string& hexStr)
+    {
+        T value;
+        jsoncpp::parse_cbor(value, unhex(hexStr));
+        return value;
+    }
+}
+
+TEST_CASE("Writing CBOR scalars", "[cbor]")
+{
+    CHECK(encode(0) == "00");
+    CHECK(encode(23) == "17");
+    CHECK(encode(24) == "1818");
+    CHECK(encode(100) == "1864");
+    CHECK(encode(1000) == "1903e8");
+    CHECK(encode(1000000) == "1a000f4240");
+    CHECK(encode(1000000000000LL) == "1b000000e8d4a51000");
+    CHECK(encode(-1) == "20");
+    CHECK(encode(-100) == "3863");
+    CHECK(encode(-1000) == "3903e7");
+    CHECK(encode(1.5) == "fa3fc00000");
+    CHECK(encode(1.1) == "fb3ff199999999999a");
+    CHECK(encode(true) == "f5");
+    CHECK(encode(std::string{"IETF"}) == "6449455446");
+    CHECK(encode(std::wstring{L"\u00FC"}) == "62c3bc");
+}
+
+TEST_CASE("Reading CBOR scalars", "[cbor]")
+{
+    CHECK(decode<int>("1903e8") == 1000);
+    CHECK(decode<long long>("1b000000e8d4a51000") == 1000000000000LL);
+    CHECK(decode<int>("3903e7") == -1000);
+    CHECK(decode<double>("f93e00") == 1.5);
+    CHECK(decode<double>("f90001") == std::ldexp(1.0, -24));
+    CHECK(std::isinf(decode<double>("f97c00")));
+    CHECK(decode<double>("fa47c35000") == 100000.0);
+    CHECK(decode<double>("fb3ff199999999999a") == 1.1);
+    CHECK(decode<bool>("f4") == false);
+    CHECK(decode<std::string>("6449455446") == "IETF");
+    CHECK(decode<std::string>("c074323031332d30332d32315432303a30343a30305a") == "2013-03-21T20:04:00Z");
+    CHECK(decode<std::string>("7f657374726561646d696e67ff") == "streaming");
+    CHECK(decode<std::wstring>("62c3bc") == L"\u00FC");
+    CHECK(decode<std::shared_ptr<int>>("f6") == nullptr);
+
+    REQUIRE_THROWS_AS(decode<int>("19"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(decode<int>("6161"), const jsoncpp::ParserError&);
+}
+
+TEST_CASE("CBOR 64-bit integers round-trip exactly", "[cbor]")
+{
+    std::vector<long long> signed64{9007199254740993LL, -9007199254740993LL, std::numeric_limits<long long>::min(),
+        std::numeric_limits<long long>::max()};
+    std::vector<long long> signedResult;
+    jsoncpp::parse_cbor(signedResult, jsoncpp::to_cbor(signed64));
+    CHECK(signedResult == signed64);
+
+    std::vector<unsigned long long> unsigned64{std::numeric_limits<unsigned long long>::max(), 9007199254740993ULL};
+    std::vector<unsigned long long> unsignedResult;
+    jsoncpp::parse_cbor(unsignedResult, jsoncpp::to_cbor(unsigned64));
+    CHECK(unsignedResult == unsigned64);
+
+    // -2^64 and -2^63 - 1 don't fit in any integer type
+    REQUIRE_THROWS_AS(decode<long long>("3bffffffffffffffff"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(decode<long long>("3b8000000000000000"), const jsoncpp::ParserError&);
+    CHECK(decode<double>("3bffffffffffffffff") == -18446744073709551616.0);
+}
+
+TEST_CASE("Reading CBOR collections", "[cbor]")
+{
+    using Nested = std::vector<std::vector<int>>;
+    auto expected = Nested{{1}, {2, 3}, {4, 5}};
+    CHECK(decode<Nested>("838101820203820405") == expected);
+    CHECK(decode<Nested>("9f9f01ff820203820405ff") == expected);
+
+    auto map = decode<std::map<std::string, std::vector<int>>>("a2616181016162820203");
+    CHECK(map.size() == 2);
+    CHECK(map["a"] == std::vector<int>{1});
+    CHECK(map["b"] == (std::vector<int>{2, 3}));
+}
+
+namespace
+{
+    struct Point
+    {
+        int x, y;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Point& o)
+    {
+        fields(o, stream, "x", o.x, "y", o.y);
+    }
+
+    struct Foo
+    {
+        bool b;
+        double d;
+        float f;
+        std::string str;
+        std::wstring wstr;
+        Point pt;
+        std::shared_ptr<Foo> ptr;
+        std::vector<int> arr;
+        std::map<std::string, long long> map;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Foo& o)
+    {
+        fields(o, stream, "b", o.b, "d", o.d, "f", o.f, "str", o.str, "wstr", o.wstr,
+            "pt", o.pt, "ptr", o.ptr, "arr", o.arr, "map", o.map);
+    }
+}
+
+TEST_CASE("CBOR round-trip of a user-defined type", "[cbor]")
+{
+    Foo foo{true, 0.1, 2.5f, "str", L"w\u0189", {1, -2}, nullptr, {1, 2, 3}, {{"a", -5000000000LL}}};
+    foo.ptr = std::make_shared<Foo>();
+    foo.ptr->d = 42;
+
+    auto data = jsoncpp::to_cbor(foo);
+    CHECK(data.size() < jsoncpp::to_string(foo).size());
+
+    Foo result;
+    std::istringstream stream{data};
+    jsoncpp::parse_cbor(result, stream);
+
+    CHECK(result.b == true);
+    CHECK(result.d == 0.1);
+    CHECK(result.f == 2.5f);
+    CHECK(result.str == "str");
+    CHECK(result.wstr == L"w\u0189");
+    CHECK(result.pt.x == 1);
+    CHECK(result.pt.y == -2);
+    REQUIRE(result.ptr != nullptr);
+    CHECK(result.ptr->d == 42);
+    CHECK(result.ptr->ptr == nullptr);
+    CHECK(result.arr == (std::vector<int>{1, 2, 3}));
+    CHECK(result.map == foo.map);
+}
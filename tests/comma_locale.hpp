@@ -0,0 +1,40 @@
+// JSON for C++ : a C locale with a comma decimal point for tests
+// Belongs to the public domain
+
+#pragma once
+
+#include <clocale>
+#include <string>
+
+// Sets LC_NUMERIC to a locale which formats 0.5 as "0,5" for its lifetime.
+// Such locales aren't installed everywhere, `isSet()` tells if one was found.
+class CommaLocale
+{
+public:
+    CommaLocale()
+    {
+        m_previous = std::setlocale(LC_NUMERIC, nullptr);
+        for (auto name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "ru_RU.UTF-8"})
+        {
+            if (std::setlocale(LC_NUMERIC, name) != nullptr)
+            {
+                m_isSet = true;
+                return;
+            }
+        }
+    }
+
+    ~CommaLocale()
+    {
+        std::setlocale(LC_NUMERIC, m_previous.c_str());
+    }
+
+    CommaLocale(const CommaLocale&) = delete;
+    void operator=(const CommaLocale&) = delete;
+
+    bool isSet() const { return m_isSet; }
+
+private:
+    std::string m_previous;
+    bool m_isSet{false};
+};
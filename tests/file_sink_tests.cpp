@@ -0,0 +1,151 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#if !defined _WIN32
+
+#include "catch_wrap.hpp"
+#include "comma_locale.hpp"
+
+#include <json-cpp/file_sink.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/std_types.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    struct Record
+    {
+        int i;
+        double d;
+        std::string s;
+        std::vector<long long> arr;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Record& o)
+    {
+        fields(o, stream, "i", o.i, "d", o.d, "s", o.s, "arr", o.arr);
+    }
+
+    std::string readAll(std::FILE* file)
+    {
+        std::string result;
+        std::rewind(file);
+        for (int ch; (ch = std::fgetc(file)) != EOF;)
+            result.push_back(static_cast<char>(ch));
+        return result;
+    }
+
+    template<class T>
+    std::string writeToFile(const T& obj, std::size_t bufferSize, jsoncpp::FileSink::Mode mode)
+    {
+        auto file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        {
+            jsoncpp::FileSink sink{fileno(file), bufferSize, mode};
+            jsoncpp::Generator<jsoncpp::details::Traits2<char, jsoncpp::FileSink>> stream{sink};
+            serialize(stream, const_cast<T&>(obj));
+            sink.finish();
+        }
+
+        auto result = readAll(file);
+        std::fclose(file);
+        return result;
+    }
+}
+
+TEST_CASE("Writing to a file descriptor", "[gen][file_sink]")
+{
+    Record obj{-42, 0.1234567, std::string(10000, 'x') + "\"\n", {0, -9223372036854775807LL, 1}};
+    auto expected = jsoncpp::to_string(obj);
+
+    SECTION("default buffer")
+    {
+        auto file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        jsoncpp::to_fd(obj, fileno(file));
+        REQUIRE(readAll(file) == expected);
+        std::fclose(file);
+    }
+
+    SECTION("small buffer")
+    {
+        REQUIRE(writeToFile(obj, 1, jsoncpp::FileSink::Buffered) == expected);
+    }
+
+    SECTION("aligned buffer")
+    {
+        REQUIRE(writeToFile(obj, 1, jsoncpp::FileSink::Aligned) == expected);
+    }
+
+    SECTION("empty buffer size")
+    {
+        REQUIRE(writeToFile(obj, 0, jsoncpp::FileSink::Buffered) == expected);
+        REQUIRE(writeToFile(obj, 0, jsoncpp::FileSink::Aligned) == expected);
+    }
+}
+
+TEST_CASE("File sink numbers don't depend on the C locale", "[gen][file_sink]")
+{
+    CommaLocale locale;
+    if (!locale.isSet())
+    {
+        WARN("No locale with a comma decimal point is installed");
+        return;
+    }
+
+    std::vector<double> values{0.5, -1.25e-7, 3};
+    REQUIRE(writeToFile(values, 4096, jsoncpp::FileSink::Buffered) == "[0.5, -1.25e-07, 3]");
+}
+
+#if defined O_DIRECT
+TEST_CASE("File sink restores O_DIRECT after finishing", "[gen][file_sink]")
+{
+    char path[] = "/var/tmp/jsoncpp_direct_XXXXXX";
+    auto fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    std::remove(path);
+
+    // Some file systems, e.g. tmpfs, don't support O_DIRECT
+    auto flags = fcntl(fd, F_GETFL);
+    if (fcntl(fd, F_SETFL, flags | O_DIRECT) == 0 && (fcntl(fd, F_GETFL) & O_DIRECT) != 0)
+    {
+        jsoncpp::FileSink sink{fd, 4096, jsoncpp::FileSink::Aligned};
+        sink << "[1, 2, 3]";
+        sink.finish();
+        CHECK((fcntl(fd, F_GETFL) & O_DIRECT) != 0);
+    }
+    else
+    {
+        WARN("O_DIRECT is not supported for " << path);
+    }
+
+    ::close(fd);
+}
+#endif
+
+TEST_CASE("File sink passes large chunks to writev", "[gen][file_sink]")
+{
+    auto file = std::tmpfile();
+    REQUIRE(file != nullptr);
+
+    std::string chunk(20000, 'y');
+    {
+        jsoncpp::FileSink sink{fileno(file), 4096};
+        sink << "[";
+        sink.write(chunk.data(), chunk.size());
+        sink << 1.5 << ']';
+    }
+
+    REQUIRE(readAll(file) == "[" + chunk + "1.5]");
+    std::fclose(file);
+}
+
+#endif
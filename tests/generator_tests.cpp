@@ -2,12 +2,21 @@
 // Belongs to the public domain
 
 #include "catch_wrap.hpp"
+#include "comma_locale.hpp"
 
 #include <json-cpp/details/string_writer.hpp>
 #include <json-cpp/generate.hpp>
 #include <json-cpp/serialization_helpers.hpp>
 #include <json-cpp/std_types.hpp>
 
+#include <array>
+#include <list>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 namespace
 {
     template<std::size_t N>
@@ -15,7 +24,7 @@ namespace
     {
         std::string str{strLit, strLit + N - 1};
         std::ostringstream rawStream;
-        auto&& sink = [&rawStream](char c) { rawStream.put(c); };
+        auto&& sink = [&rawStream](const char* data, std::size_t size) { rawStream.write(data, size); };
         jsoncpp::details::writeString(str, sink);
         return rawStream.str();
     }
@@ -35,6 +44,48 @@ TEST_CASE("Writing String", "[gen]")
     REQUIRE(writeStr("\xA2") == "\"\xA2\"");
 }
 
+namespace
+{
+    template<typename CharT>
+    std::string writeWide(const std::basic_string<CharT>& str, bool escapeNonAscii = false)
+    {
+        std::string result;
+        jsoncpp::details::writeString(str, [&result](const char* data, std::size_t size) { result.append(data, size); }, escapeNonAscii);
+        return result;
+    }
+}
+
+TEST_CASE("Writing wide strings", "[gen]")
+{
+    auto&& utf8 = "\"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x8D\x8C\\n\"";
+    REQUIRE(writeWide(std::u16string{u"caf\u00e9 \u20ac \U0001F34C\n"}) == utf8);
+    REQUIRE(writeWide(std::u32string{U"caf\u00e9 \u20ac \U0001F34C\n"}) == utf8);
+    REQUIRE(writeWide(std::wstring{L"caf\u00e9"}) == "\"caf\xC3\xA9\"");
+
+    // Lone surrogates and values out of the Unicode range
+    REQUIRE(writeWide(std::u16string{0xD800, u'x'}) == "\"\xEF\xBF\xBDx\"");
+    REQUIRE(writeWide(std::u16string{u'x', 0xDC00}) == "\"x\xEF\xBF\xBD\"");
+    REQUIRE(writeWide(std::u32string{0x110000}) == "\"\xEF\xBF\xBD\"");
+
+    std::u32string text(100, U'a');
+    text[40] = U'\u00e9';
+    text[70] = U'"';
+    REQUIRE(writeWide(text) == '"' + std::string(40, 'a') + "\xC3\xA9" + std::string(29, 'a') + "\\\"" + std::string(29, 'a') + '"');
+}
+
+TEST_CASE("Escaping non-ASCII characters", "[gen]")
+{
+    REQUIRE(writeWide(std::string{"caf\xC3\xA9 \xF0\x9F\x8D\x8C"}, true) == R"("caf\u00E9 \uD83C\uDF4C")");
+    REQUIRE(writeWide(std::u16string{u"\u20ac\U0001F34C"}, true) == R"("\u20AC\uD83C\uDF4C")");
+    REQUIRE(writeWide(std::string{"\xC3("}, true) == R"("\uFFFD(")");
+
+    jsoncpp::GeneratorOptions options;
+    options.escapeNonAscii = true;
+    std::vector<std::wstring> arr{L"\u00e9", L"x"};
+    REQUIRE(jsoncpp::to_string(arr, options) == R"(["\u00E9", "x"])");
+    REQUIRE(jsoncpp::to_string(arr) == "[\"\xC3\xA9\", \"x\"]");
+}
+
 namespace
 {
     struct SingleField
@@ -88,6 +139,21 @@ TEST_CASE("Writing Object with many fields", "[gen]")
     REQUIRE(jsoncpp::to_string(obj) == R"({"x": 1, "y": 2})");
 }
 
+TEST_CASE("Field names are escaped", "[gen]")
+{
+    std::map<std::string, int> obj{{"a\"b\n", 1}};
+    REQUIRE(jsoncpp::to_string(obj) == R"({"a\"b\n": 1})");
+}
+
+TEST_CASE("Integer map keys are written as strings", "[gen]")
+{
+    std::map<long long, int> obj{{-9223372036854775807LL - 1, 1}, {0, 2}, {42, 3}};
+    REQUIRE(jsoncpp::to_string(obj) == R"({"-9223372036854775808": 1, "0": 2, "42": 3})");
+
+    std::unordered_map<unsigned short, bool> flags{{65535, true}};
+    REQUIRE(jsoncpp::to_string(flags) == R"({"65535": true})");
+}
+
 TEST_CASE("Writing standard types", "[gen]")
 {
     Foo obj;
@@ -95,4 +161,76 @@ TEST_CASE("Writing standard types", "[gen]")
     obj.arr.push_back(2);
     obj.p.reset(new Foo);
     REQUIRE(jsoncpp::to_string(obj) == R"({"arr": [1, 2], "p": {"arr": [], "p": null}})");
-}
\ No newline at end of file
+}
+
+TEST_CASE("Writing fixed-size types", "[gen]")
+{
+    std::array<double, 3> point{{1, 2.5, -3}};
+    REQUIRE(jsoncpp::to_string(point) == "[1, 2.5, -3]");
+
+    int ids[2][2] = {{1, 2}, {3, 4}};
+    REQUIRE(jsoncpp::to_string(ids) == "[[1, 2], [3, 4]]");
+
+    REQUIRE(jsoncpp::to_string(std::make_tuple(7, std::string{"seven"}, true)) == R"([7, "seven", true])");
+    REQUIRE(jsoncpp::to_string(std::make_pair(std::string{"x"}, 0.5)) == R"(["x", 0.5])");
+
+    // Character arrays are written up to the null character
+    char name[8] = "a\"b";
+    REQUIRE(jsoncpp::to_string(name) == R"("a\"b")");
+    REQUIRE(jsoncpp::to_string(jsoncpp::FixedString<4>{"abcd"}) == R"("abcd")");
+}
+
+TEST_CASE("Writing arrays of numbers", "[gen]")
+{
+    // Vectors of numbers are formatted in batches, lists item by item
+    std::vector<double> arr;
+    for (auto i = 0; i != 1000; ++i)
+        arr.push_back(i * 1.25e-3 - 0.5);
+    std::list<double> list{arr.begin(), arr.end()};
+    REQUIRE(jsoncpp::to_string(arr) == jsoncpp::to_string(list));
+
+    std::vector<long long> ints{0, -9223372036854775807LL, 42};
+    REQUIRE(jsoncpp::to_string(ints) == "[0, -9223372036854775807, 42]");
+    REQUIRE(jsoncpp::to_string(std::vector<float>{}) == "[]");
+
+    // Streams with other formatting settings format each number
+    std::ostringstream rawStream;
+    rawStream.precision(10);
+    jsoncpp::Generator<jsoncpp::details::Traits2<char, std::ostream>> stream{rawStream};
+    std::vector<double> pi{3.14159265358979};
+    serialize(stream, pi);
+    REQUIRE(rawStream.str() == "[3.141592654]");
+}
+
+TEST_CASE("Character types aren't numbers", "[gen]")
+{
+    using jsoncpp::details::IsNumber;
+    using jsoncpp::details::IsIntegerKey;
+
+    static_assert(IsNumber<short>::value && IsNumber<unsigned long long>::value && IsNumber<float>::value, "");
+    static_assert(!IsNumber<bool>::value && !IsNumber<char>::value && !IsNumber<signed char>::value, "");
+    static_assert(!IsNumber<wchar_t>::value && !IsNumber<char16_t>::value && !IsNumber<char32_t>::value, "");
+
+    static_assert(IsIntegerKey<int>::value && IsIntegerKey<unsigned short>::value, "");
+    static_assert(!IsIntegerKey<double>::value && !IsIntegerKey<bool>::value && !IsIntegerKey<char>::value, "");
+    static_assert(!IsIntegerKey<wchar_t>::value && !IsIntegerKey<char16_t>::value && !IsIntegerKey<char32_t>::value, "");
+}
+
+TEST_CASE("Batches of numbers don't depend on the C locale", "[gen]")
+{
+    CommaLocale locale;
+    if (!locale.isSet())
+    {
+        WARN("No locale with a comma decimal point is installed");
+        return;
+    }
+
+    // Batches are formatted with snprintf, items with the stream, which has the classic locale
+    std::vector<double> arr{0.5, -1.25e-7, 3, 1e300};
+    std::list<double> list{arr.begin(), arr.end()};
+    REQUIRE(jsoncpp::to_string(arr) == jsoncpp::to_string(list));
+    REQUIRE(jsoncpp::to_string(arr) == "[0.5, -1.25e-07, 3, 1e+300]");
+
+    std::vector<long double> longs{0.25L};
+    REQUIRE(jsoncpp::to_string(longs) == "[0.25]");
+}
@@ -0,0 +1,177 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/msgpack.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/std_types.hpp>
+
+#include <array>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    std::string hex(const std::string& bytes)
+    {
+        const auto table = "0123456789abcdef";
+        std::string result;
+        for (auto ch : bytes)
+        {
+            auto n = static_cast<unsigned char>(ch);
+            result.push_back(table[n >> 4]);
+            result.push_back(table[n & 15]);
+        }
+        return result;
+    }
+
+    std::string unhex(const std::string& str)
+    {
+        std::string result;
+        for (std::size_t i = 0; i + 1 < str.size(); i += 2)
+            result.push_back(static_cast<char>(std::stoi(str.substr(i, 2), nullptr, 16)));
+        return result;
+    }
+
+    template<typename T>
+    std::string encode(T value)
+    {
+        return hex(jsoncpp::to_msgpack(value));
+    }
+
+    template<typename T>
+    T decode(const std::string& hexStr)
+    {
+        T value;
+        jsoncpp::parse_msgpack(value, unhex(hexStr));
+        return value;
+    }
+}
+
+TEST_CASE("Writing MessagePack scalars", "[msgpack]")
+{
+    CHECK(encode(0) == "00");
+    CHECK(encode(127) == "7f");
+    CHECK(encode(128) == "cc80");
+    CHECK(encode(256) == "cd0100");
+    CHECK(encode(70000u) == "ce00011170");
+    CHECK(encode(-1) == "ff");
+    CHECK(encode(-32) == "e0");
+    CHECK(encode(-33) == "d0df");
+    CHECK(encode(-129) == "d1ff7f");
+    CHECK(encode(-5000000000LL) == "d3fffffffed5fa0e00");
+    CHECK(encode(1.5) == "cb3ff8000000000000");
+    CHECK(encode(1.5f) == "ca3fc00000");
+    CHECK(encode(true) == "c3");
+    CHECK(encode(std::shared_ptr<int>()) == "c0");
+    CHECK(encode(std::string{"abc"}) == "a3616263");
+    CHECK(encode(std::string(32, 'x')).substr(0, 4) == "d920");
+    CHECK(encode(std::wstring{L"\u00FC"}) == "a2c3bc");
+}
+
+TEST_CASE("Writing MessagePack collections", "[msgpack]")
+{
+    CHECK(encode(std::vector<int>{1, 2}) == "920102");
+    CHECK(encode(std::vector<std::vector<int>>{{}, {1}}) == "929091" "01");
+    CHECK(encode(std::map<std::string, int>{{"a", 1}}) == "81a16101");
+    CHECK(encode(std::vector<int>(15, 1)) == "9f" "010101010101010101010101010101");
+    CHECK(encode(std::vector<int>(16, 1)) == "dc0010" "01010101010101010101010101010101");
+}
+
+TEST_CASE("Reading MessagePack", "[msgpack]")
+{
+    CHECK(decode<int>("d0df") == -33);
+    CHECK(decode<long long>("d3fffffffed5fa0e00") == -5000000000LL);
+    CHECK(decode<unsigned>("ce00011170") == 70000u);
+    CHECK(decode<double>("ca3fc00000") == 1.5);
+    CHECK(decode<std::string>("a3616263") == "abc");
+    CHECK(decode<std::string>("c403616263") == "abc");
+    CHECK(decode<std::wstring>("a2c3bc") == L"\u00FC");
+    CHECK(decode<std::vector<int>>("dc0003010203") == (std::vector<int>{1, 2, 3}));
+
+    auto map = decode<std::map<std::string, std::vector<int>>>("82a16190a162920102");
+    CHECK(map["a"].empty());
+    CHECK(map["b"] == (std::vector<int>{1, 2}));
+
+    REQUIRE_THROWS_AS(decode<int>("cd01"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(decode<int>("a0"), const jsoncpp::ParserError&);
+}
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        double score;
+        float ratio;
+        std::string name;
+        jsoncpp::StringRef tag;
+        std::vector<long long> values;
+        std::map<std::string, bool> flags;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Record& o)
+    {
+        fields(o, stream, "id", o.id, "score", o.score, "ratio", o.ratio, "name", o.name,
+            "tag", o.tag, "values", o.values, "flags", o.flags);
+    }
+}
+
+TEST_CASE("MessagePack round-trip with zero-copy strings", "[msgpack]")
+{
+    std::string tag{"zero-copy"};
+    Record rec{-7, 0.25, 0.5f, "name", {tag.data(), tag.size()}, {1, -300, 1LL << 40}, {{"x", true}, {"y", false}}};
+
+    auto data = jsoncpp::to_msgpack(rec);
+
+    Record result{};
+    jsoncpp::parse_msgpack(result, data);
+    CHECK(result.id == -7);
+    CHECK(result.score == 0.25);
+    CHECK(result.ratio == 0.5f);
+    CHECK(result.name == "name");
+    CHECK(result.tag.str() == "zero-copy");
+    CHECK(result.tag.data >= data.data());
+    CHECK(result.tag.data < data.data() + data.size());
+    CHECK(result.values == rec.values);
+    CHECK(result.flags == rec.flags);
+}
+
+TEST_CASE("MessagePack 64-bit integers round-trip exactly", "[msgpack]")
+{
+    std::vector<long long> signed64{9007199254740993LL, -9007199254740993LL, std::numeric_limits<long long>::min(),
+        std::numeric_limits<long long>::max(), -1, -129};
+    std::vector<long long> signedResult;
+    jsoncpp::parse_msgpack(signedResult, jsoncpp::to_msgpack(signed64));
+    CHECK(signedResult == signed64);
+
+    std::vector<unsigned long long> unsigned64{std::numeric_limits<unsigned long long>::max(), 9007199254740993ULL, 0};
+    std::vector<unsigned long long> unsignedResult;
+    jsoncpp::parse_msgpack(unsignedResult, jsoncpp::to_msgpack(unsigned64));
+    CHECK(unsignedResult == unsigned64);
+
+    // Doubles with whole values are integers, others aren't
+    CHECK(decode<int>("cb4059000000000000") == 100);
+    REQUIRE_THROWS_AS(decode<int>("cb3ff8000000000000"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(decode<unsigned>("ff"), const jsoncpp::ParserError&);
+}
+
+TEST_CASE("MessagePack with fixed-size types", "[msgpack]")
+{
+    std::tuple<jsoncpp::FixedString<4>, std::array<int, 2>> value{"abcd", {{1, -2}}};
+    auto data = jsoncpp::to_msgpack(value);
+
+    std::tuple<jsoncpp::FixedString<4>, std::array<int, 2>> result;
+    jsoncpp::parse_msgpack(result, data);
+    CHECK(std::get<0>(result) == "abcd");
+    CHECK(std::get<1>(result)[1] == -2);
+
+    std::tuple<jsoncpp::FixedString<3>, std::array<int, 2>> small;
+    CHECK_THROWS_AS(jsoncpp::parse_msgpack(small, data), const jsoncpp::ParserError&);
+}
@@ -0,0 +1,119 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/on_demand.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/std_types.hpp>
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char* const onDemandText = R"(
+        {
+            "skipped": {"a": [1, {"b": "}]"}], "c": "\"{["},
+            "num": 42, // comment with a bracket ]
+            "str": "text",
+            "arr": [1, "two", [3], {"four": 4}, true],
+            "obj": {"x": 1, "y": 2},
+            "last": null
+        }
+    )";
+
+    struct Point
+    {
+        int x, y;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Point& o)
+    {
+        fields(o, stream, "x", o.x, "y", o.y);
+    }
+
+    template<typename T, typename = void>
+    struct CanParseOnDemand : std::false_type {};
+
+    template<typename T>
+    struct CanParseOnDemand<T, decltype(jsoncpp::parse_on_demand(std::declval<T>()), void())> : std::true_type {};
+}
+
+TEST_CASE("On-demand field access", "[on_demand]")
+{
+    auto doc = jsoncpp::parse_on_demand(onDemandText);
+    REQUIRE(doc["num"].getNumber() == 42);
+    REQUIRE(doc["str"].getString() == "text");
+
+    Point pt;
+    doc["obj"].get(pt);
+    REQUIRE(pt.x == 1);
+    REQUIRE(pt.y == 2);
+
+    REQUIRE(doc["last"].getType() == jsoncpp::Type::Null);
+}
+
+TEST_CASE("On-demand access is forward-only", "[on_demand]")
+{
+    std::string text{onDemandText};
+    auto doc = jsoncpp::parse_on_demand(text);
+    REQUIRE(doc["arr"].getType() == jsoncpp::Type::Array);
+    REQUIRE_THROWS_AS(doc["num"], const jsoncpp::ParserError&);
+}
+
+TEST_CASE("On-demand documents of strings", "[on_demand]")
+{
+    // The document reads the characters of the string in place, so a temporary string isn't accepted
+    static_assert(CanParseOnDemand<const std::string&>::value, "");
+    static_assert(!CanParseOnDemand<std::string>::value, "");
+    static_assert(std::is_same<decltype(jsoncpp::parse_on_demand(std::declval<const std::string&>())),
+        jsoncpp::OnDemandDocument<jsoncpp::details::Traits2<char, const char*>>>::value, "");
+
+    std::string text{onDemandText};
+    auto doc = jsoncpp::parse_on_demand(text);
+    REQUIRE(doc["str"].getString() == "text");
+    REQUIRE(doc["last"].getType() == jsoncpp::Type::Null);
+}
+
+TEST_CASE("On-demand iteration", "[on_demand]")
+{
+    std::stringstream stream{onDemandText};
+    auto doc = jsoncpp::parse_on_demand(stream);
+
+    std::vector<jsoncpp::Type> types;
+    for (auto& element : doc["arr"])
+        types.push_back(element.getType());
+
+    std::vector<jsoncpp::Type> expected{jsoncpp::Type::Number, jsoncpp::Type::String,
+        jsoncpp::Type::Array, jsoncpp::Type::Object, jsoncpp::Type::Boolean};
+    REQUIRE(types == expected);
+
+    auto obj = doc["obj"];
+    std::vector<std::string> names;
+    for (auto& field : obj)
+    {
+        names.push_back(obj.fieldName());
+        field.getNumber();
+    }
+
+    REQUIRE(names == (std::vector<std::string>{"x", "y"}));
+    REQUIRE(doc["last"].getType() == jsoncpp::Type::Null);
+}
+
+TEST_CASE("On-demand nested values are skipped when partially consumed", "[on_demand]")
+{
+    auto doc = jsoncpp::parse_on_demand(onDemandText);
+    auto skipped = doc["skipped"];
+    auto a = skipped["a"];
+    jsoncpp::OnDemandValue<jsoncpp::details::Traits2<char, jsoncpp::details::CStrIterator<char>>> first;
+    REQUIRE(a.next(first));
+    REQUIRE(first.getNumber() == 1);
+
+    REQUIRE(doc["num"].getNumber() == 42);
+    REQUIRE_THROWS_AS(doc["str"].getNumber(), const jsoncpp::ParserError&);
+}
@@ -0,0 +1,118 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/parallel_generate.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/std_types.hpp>
+#include <json-cpp/stats.hpp>
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Item
+    {
+        int id;
+        std::string name;
+        std::vector<double> values;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Item& o)
+    {
+        fields(o, stream, "id", o.id, "name", o.name, "values", o.values);
+    }
+
+    struct Throwing {};
+
+    template<class X>
+    inline void serialize(jsoncpp::Generator<X>&, Throwing&)
+    {
+        throw std::runtime_error("cannot serialize");
+    }
+}
+
+TEST_CASE("Parallel generation is identical to sequential", "[gen][parallel]")
+{
+    std::vector<Item> items;
+    for (auto i = 0; i != 1000; ++i)
+        items.push_back(Item{i, "item \"" + std::to_string(i) + '"', std::vector<double>(i % 4, i / 7.0)});
+
+    jsoncpp::ParallelOptions options;
+    options.threads = 4;
+    options.chunkSize = 7;
+    REQUIRE(jsoncpp::to_string_parallel(items, options) == jsoncpp::to_string(items));
+
+    options.chunkSize = 1000;
+    REQUIRE(jsoncpp::to_string_parallel(items, options) == jsoncpp::to_string(items));
+
+    std::vector<Item> empty;
+    REQUIRE(jsoncpp::to_string_parallel(empty, options) == "[]");
+}
+
+TEST_CASE("Parallel generation uses the generator options", "[gen][parallel]")
+{
+    std::vector<Item> items;
+    for (auto i = 0; i != 100; ++i)
+        items.push_back(Item{i, "caf\xC3\xA9", {}});
+
+    jsoncpp::ParallelOptions options;
+    options.threads = 4;
+    options.chunkSize = 7;
+    jsoncpp::GeneratorOptions generatorOptions;
+    generatorOptions.escapeNonAscii = true;
+
+    auto parallel = jsoncpp::to_string_parallel(items, generatorOptions, options);
+    REQUIRE(parallel == jsoncpp::to_string(items, generatorOptions));
+    REQUIRE(parallel.find("caf\\u00E9") != std::string::npos);
+
+    // Generators with statistics write sequentially, so every value is counted
+    jsoncpp::Stats stats;
+    std::ostringstream rawStream;
+    jsoncpp::Generator<jsoncpp::details::Traits2<char, std::ostream, jsoncpp::CollectStats>> stream{rawStream, jsoncpp::CollectStats{stats}};
+    jsoncpp::writeRangeParallel(stream, items, options);
+    REQUIRE(rawStream.str() == jsoncpp::to_string(items));
+    REQUIRE(stats.objects == items.size());
+}
+
+TEST_CASE("Parallel generation keeps the number format of the sink", "[gen][parallel]")
+{
+    std::vector<Item> items;
+    for (auto i = 0; i != 100; ++i)
+        items.push_back(Item{i, "item", {i / 3.0}});
+
+    jsoncpp::ParallelOptions options;
+    options.threads = 4;
+    options.chunkSize = 7;
+
+    auto write = [&](bool parallel)
+    {
+        std::ostringstream rawStream;
+        rawStream << std::setprecision(17);
+        jsoncpp::Generator<jsoncpp::details::Traits2<char, std::ostream>> stream{rawStream};
+        if (parallel)
+            jsoncpp::writeRangeParallel(stream, items, options);
+        else
+            jsoncpp::writeRange(stream, items);
+        return rawStream.str();
+    };
+
+    auto parallel = write(true);
+    REQUIRE(parallel == write(false));
+    REQUIRE(parallel.find("0.33333333333333331") != std::string::npos);
+}
+
+TEST_CASE("Parallel generation rethrows errors", "[gen][parallel]")
+{
+    std::vector<Throwing> items(100);
+    jsoncpp::ParallelOptions options;
+    options.threads = 3;
+    options.chunkSize = 10;
+    REQUIRE_THROWS_AS(jsoncpp::to_string_parallel(items, options), const std::runtime_error&);
+}
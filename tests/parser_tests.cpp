@@ -8,6 +8,11 @@
 
 #include <json-cpp/details/parser_utility.hpp>
 
+#include <cfloat>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
 static double parseNum(std::string str)
 {
     str += ",";
@@ -35,6 +40,25 @@ TEST_CASE("Parsing Number", "[parser]")
     REQUIRE(parseNum("1.5e10") == 1.5e10);
 }
 
+TEST_CASE("Parsing Number is correctly rounded", "[parser]")
+{
+    REQUIRE(parseNum("0.1") == 0.1);
+    REQUIRE(parseNum("0.3") == 0.3);
+    REQUIRE(parseNum("123456.789e-3") == 123.456789);
+    REQUIRE(parseNum("0.000001") == 1e-6);
+    REQUIRE(parseNum("1.7976931348623157e308") == 1.7976931348623157e308);
+    REQUIRE(parseNum("2.2250738585072014e-308") == 2.2250738585072014e-308);
+    REQUIRE(parseNum("4.9406564584124654e-324") == 4.9406564584124654e-324);
+    REQUIRE(parseNum("0.1000000000000000055511151231257827021181583404541015625") == 0.1);
+
+    // 2^53 + 1 is halfway, it's rounded to even unless any following digit is nonzero
+    REQUIRE(parseNum("9007199254740993") == 9007199254740992.0);
+    REQUIRE(parseNum("9007199254740993." + std::string(1000, '0') + "1") == 9007199254740994.0);
+
+    REQUIRE(parseNum("1e400") == HUGE_VAL);
+    REQUIRE(parseNum("1e-400") == 0);
+}
+
 template<typename CharT>
 static std::basic_string<CharT> parseStr(std::string str)
 {
@@ -71,13 +95,37 @@ TEST_CASE("Parsing String to std::wstring", "[parser]")
 {
     REQUIRE(parseStr<wchar_t>("\\u0189") == L"\u0189");
     REQUIRE(parseStr<wchar_t>("\\uaAfF") == L"\uaaff");
+    REQUIRE(parseStr<wchar_t>("a\\tb") == L"a\tb");
+    REQUIRE(parseStr<wchar_t>("caf\xC3\xA9 \xE2\x82\xAC") == L"caf\u00e9 \u20ac");
+}
+
+TEST_CASE("Transcoding UTF-8 to UTF-16 and UTF-32", "[parser]")
+{
+    REQUIRE(parseStr<char16_t>("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x8D\x8C\\n") == u"\u00e9\u20ac\U0001F34C\n");
+    REQUIRE(parseStr<char32_t>("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x8D\x8C\\n") == U"\u00e9\u20ac\U0001F34C\n");
+
+    // Malformed sequences are replaced
+    REQUIRE(parseStr<char16_t>("a\xC3") == u"a\uFFFD");
+    REQUIRE(parseStr<char16_t>("\xE2\x82z") == u"\uFFFDz");
+    REQUIRE(parseStr<char16_t>("\xC0\x80") == u"\uFFFD\uFFFD");
+    REQUIRE(parseStr<char32_t>("\xED\xA0\x80") == U"\uFFFD\uFFFD\uFFFD");
 }
 
 #include <json-cpp/parse.hpp>
 #include <json-cpp/std_types.hpp>
+#include <json-cpp/interned_string.hpp>
 #include <json-cpp/serialization_helpers.hpp>
 
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 namespace
 {
@@ -124,6 +172,181 @@ TEST_CASE("Parsing Object", "[parser]")
     }
 }
 
+TEST_CASE("Parsing long strings from contiguous input", "[parser]")
+{
+    std::string body = "0123456789abcdef\\u00e9 quote \\\" caf\xC3\xA9, 0123456789abcdef0123456789abcdef\\n";
+    auto text = '"' + body + body + "\"";
+
+    std::string fast, slow;
+    jsoncpp::parse(fast, text);
+    jsoncpp::parse<char>(slow, std::begin(text), std::end(text));
+
+    REQUIRE(fast == slow);
+    REQUIRE(fast.size() == 2 * (body.size() - 6));
+
+    std::u16string fast16, slow16;
+    jsoncpp::parse(fast16, text);
+    jsoncpp::parse<char>(slow16, std::begin(text), std::end(text));
+    REQUIRE(fast16 == slow16);
+    REQUIRE(fast16.size() == 2 * (body.size() - 8));
+
+    std::u32string fast32, slow32;
+    jsoncpp::parse(fast32, text);
+    jsoncpp::parse<char>(slow32, std::begin(text), std::end(text));
+    REQUIRE(fast32 == slow32);
+    REQUIRE(fast32.size() == fast16.size());
+
+    text = '"' + std::string(20, 'a') + "\xE2\x82(" + std::string(20, 'b') + "\xF0\x9F\x98\x80\"";
+    jsoncpp::parse(fast16, text);
+    jsoncpp::parse<char>(slow16, std::begin(text), std::end(text));
+    REQUIRE(fast16 == slow16);
+    REQUIRE(fast16 == std::u16string(20, 'a') + u"\uFFFD(" + std::u16string(20, 'b') + u"\U0001F600");
+}
+
+namespace
+{
+    struct WideInput
+    {
+        std::string narrow;
+        std::u16string utf16;
+        std::wstring wide;
+        double num;
+
+        template<class X> void serialize(jsoncpp::Stream<X>& stream)
+        {
+            fields(*this, stream, "narrow", narrow, "utf16", utf16, "wide", wide, "num", num);
+        }
+    };
+}
+
+TEST_CASE("Parsing UTF-16 and UTF-32 input", "[parser]")
+{
+    const auto check = [](const WideInput& obj)
+    {
+        REQUIRE(obj.narrow == "caf\xC3\xA9 \xF0\x9F\x8D\x8C\n");
+        REQUIRE(obj.utf16 == u"caf\u00e9 \U0001F34C\n");
+        REQUIRE(obj.wide == L"caf\u00e9 \U0001F34C\n");
+        REQUIRE(obj.num == -12.5);
+    };
+
+    WideInput obj;
+    jsoncpp::parse(obj, u"{\"narrow\": \"caf\u00e9 \U0001F34C\\n\", \"utf16\": \"caf\u00e9 \U0001F34C\\n\", "
+        u"\"wide\": \"caf\\u00e9 \\uD83C\\uDF4C\\n\", \"num\": -12.5}");
+    check(obj);
+
+    obj = WideInput{};
+    std::u16string text16 = u"{\"narrow\": \"caf\u00e9 \U0001F34C\\n\", \"utf16\": \"caf\u00e9 \U0001F34C\\n\", "
+        u"\"wide\": \"caf\u00e9 \U0001F34C\\n\", \"num\": -12.5}";
+    jsoncpp::parse(obj, text16);
+    check(obj);
+
+    obj = WideInput{};
+    std::u32string text32 = U"{\"narrow\": \"caf\u00e9 \U0001F34C\\n\", \"utf16\": \"caf\u00e9 \U0001F34C\\n\", "
+        U"\"wide\": \"caf\u00e9 \U0001F34C\\n\", \"num\": -12.5}";
+    jsoncpp::parse(obj, text32);
+    check(obj);
+
+    obj = WideInput{};
+    std::wistringstream stream{L"{\"narrow\": \"caf\u00e9 \U0001F34C\\n\", \"utf16\": \"caf\u00e9 \U0001F34C\\n\", "
+        L"\"wide\": \"caf\u00e9 \U0001F34C\\n\", \"num\": -12.5}"};
+    jsoncpp::parse(obj, stream);
+    check(obj);
+
+    // Lone surrogates are replaced
+    std::u16string lone{u'"', u'a', char16_t(0xD800), u'b', char16_t(0xDC00), u'"'};
+    std::string str;
+    jsoncpp::parse(str, lone);
+    REQUIRE(str == "a\xEF\xBF\xBD" "b\xEF\xBF\xBD");
+    std::u16string str16;
+    jsoncpp::parse(str16, lone);
+    REQUIRE(str16 == u"a\uFFFDb\uFFFD");
+}
+
+TEST_CASE("Parsing long strings from contiguous UTF-16 input", "[parser]")
+{
+    std::u16string body = u"0123456789abcdef\\u00e9 quote \\\" caf\u00e9 \U0001F34C, 0123456789abcdef0123456789abcdef\\n";
+    auto text = u'"' + body + body + u"\"";
+
+    std::string fast, slow;
+    jsoncpp::parse(fast, text);
+    jsoncpp::parse<char16_t>(slow, std::begin(text), std::end(text));
+    REQUIRE(fast == slow);
+
+    std::u16string fast16, slow16;
+    jsoncpp::parse(fast16, text);
+    jsoncpp::parse<char16_t>(slow16, std::begin(text), std::end(text));
+    REQUIRE(fast16 == slow16);
+    REQUIRE(fast16.size() == 2 * (body.size() - 7));
+
+    std::u32string fast32, slow32;
+    jsoncpp::parse(fast32, text);
+    jsoncpp::parse<char16_t>(slow32, std::begin(text), std::end(text));
+    REQUIRE(fast32 == slow32);
+    REQUIRE(fast32.size() == fast16.size() - 2);
+}
+
+namespace
+{
+    // Column of the `InvalidUtf8` error, it must be the same with and without the fast path
+    std::size_t invalidUtf8Column(const std::string& text)
+    {
+        jsoncpp::ParserOptions options;
+        options.validateUtf8 = true;
+
+        std::string str;
+        REQUIRE_NOTHROW(jsoncpp::parse(str, text));
+
+        std::size_t columns[2] = {};
+        for (auto i = 0; i != 2; ++i)
+        {
+            try
+            {
+                if (i == 0)
+                    jsoncpp::parse(str, text, options);
+                else
+                    jsoncpp::parse(str, text.c_str(), options);
+                FAIL("no error");
+            }
+            catch (const jsoncpp::ParserError& e)
+            {
+                REQUIRE(e.type() == jsoncpp::ParserError::InvalidUtf8);
+                columns[i] = e.column();
+            }
+        }
+
+        REQUIRE(columns[0] == columns[1]);
+        return columns[0];
+    }
+}
+
+TEST_CASE("Validating UTF-8", "[parser]")
+{
+    jsoncpp::ParserOptions options;
+    options.validateUtf8 = true;
+
+    std::string valid = "\"a\xC3\xA9 \xE2\x82\xAC \xEF\xBF\xBF \xF0\x9F\x8D\x8C \xF4\x8F\xBF\xBF \\u00e9\"";
+    std::string str;
+    jsoncpp::parse(str, valid, options);
+    REQUIRE(str == valid.substr(1, valid.size() - 8) + "\xC3\xA9");
+
+    SingleField obj;
+    REQUIRE_THROWS_AS(jsoncpp::parse(obj, "{\"x\xFF\": 1}", options), const jsoncpp::ParserError&);
+
+    for (std::size_t prefix : {1, 40})
+    {
+        auto text = '"' + std::string(prefix - 1, 'a');
+        REQUIRE(invalidUtf8Column(text + "\xC0\x80\"") == prefix);       // overlong
+        REQUIRE(invalidUtf8Column(text + "\xE0\x80\xAF\"") == prefix + 1); // overlong
+        REQUIRE(invalidUtf8Column(text + "\xED\xA0\x80\"") == prefix + 1); // surrogate
+        REQUIRE(invalidUtf8Column(text + "\xF4\x90\x80\x80\"") == prefix + 1); // above U+10FFFF
+        REQUIRE(invalidUtf8Column(text + "\xF5\x80\x80\x80\"") == prefix);
+        REQUIRE(invalidUtf8Column(text + "\x80\"") == prefix);           // stray continuation
+        REQUIRE(invalidUtf8Column(text + "\xC3\"") == prefix + 1);       // truncated
+        REQUIRE(invalidUtf8Column(text + "\xE2\x82\\n\"") == prefix + 2);
+        REQUIRE(invalidUtf8Column(text + "\xC3(\"") == prefix + 1);
+    }
+}
+
 namespace
 {
     struct BooleanField
@@ -225,6 +448,302 @@ TEST_CASE("Parsing to different arithmetic types", "[parser]")
     REQUIRE(obj._d == 52);
 }
 
+TEST_CASE("Parsing integers exactly", "[parser]")
+{
+    std::int64_t i64;
+    jsoncpp::parse(i64, "9007199254740993");
+    REQUIRE(i64 == 9007199254740993LL);
+    jsoncpp::parse(i64, "-9223372036854775808");
+    REQUIRE(i64 == std::numeric_limits<std::int64_t>::min());
+    jsoncpp::parse(i64, "12345678901234567.0e1");
+    REQUIRE(i64 == 123456789012345670LL);
+
+    std::uint64_t u64;
+    jsoncpp::parse(u64, "18446744073709551615");
+    REQUIRE(u64 == std::numeric_limits<std::uint64_t>::max());
+    jsoncpp::parse(u64, "18446744073709551615.000000000000000000000");
+    REQUIRE(u64 == std::numeric_limits<std::uint64_t>::max());
+
+    int i;
+    jsoncpp::parse(i, "1.0");
+    REQUIRE(i == 1);
+    jsoncpp::parse(i, "0.5e1");
+    REQUIRE(i == 5);
+    jsoncpp::parse(i, "-0");
+    REQUIRE(i == 0);
+
+    // Fractions and values out of range are errors, not casts
+    REQUIRE_THROWS_AS(jsoncpp::parse(i, "1e10"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(i, "1.5"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(i, "1e-400"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(i64, "9223372036854775808"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(i64, "1e400"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(u64, "18446744073709551616"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(u64, "-1"), const jsoncpp::ParserError&);
+}
+
+TEST_CASE("Parsing arrays of numbers", "[parser]")
+{
+    // Vectors of numbers have their own kernel, lists are parsed item by item
+    std::string text = "[ 0, -1,2.5e3 ,\n 123456789012345678, 0.000123456789012345, -98765432.123456789, 7,]";
+    std::list<double> expected;
+    jsoncpp::parse(expected, text.c_str());
+
+    std::vector<double> arr;
+    jsoncpp::parse(arr, text);
+    REQUIRE(std::equal(arr.begin(), arr.end(), expected.begin()));
+    REQUIRE(arr.size() == expected.size());
+    REQUIRE(arr[4] == 0.000123456789012345);
+
+    arr.assign(3, 1.0);
+    jsoncpp::parse(arr, text.c_str());
+    REQUIRE(std::equal(arr.begin(), arr.end(), expected.begin()));
+
+    std::istringstream stream{text};
+    jsoncpp::parse(arr, stream);
+    REQUIRE(std::equal(arr.begin(), arr.end(), expected.begin()));
+
+    std::vector<int> ints;
+    jsoncpp::parse(ints, std::string{"[]"});
+    REQUIRE(ints.empty());
+    jsoncpp::parse(ints, std::string{"[1, -2, 30000]"});
+    REQUIRE(ints == (std::vector<int>{1, -2, 30000}));
+
+    REQUIRE_THROWS_AS(jsoncpp::parse(ints, std::string{"[1, null]"}), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(ints, std::string{"[1, [2]]"}), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(ints, std::string{"[1 2]"}), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(ints, std::string{"[1.5]"}), const jsoncpp::ParserError&);
+}
+
+TEST_CASE("Counting list items ahead", "[parser]")
+{
+    auto count = [](const std::string& text)
+    {
+        jsoncpp::details::Reader<const char*> reader{text.data(), text.data() + text.size()};
+        return jsoncpp::details::countListItems(reader);
+    };
+
+    REQUIRE(count("1, 2, 3]") == 3);
+    REQUIRE(count("1.5e10, -2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16]") == 16);
+    REQUIRE(count("1, 2, 3, 4, 5, 6, 7, 8, [9, 9], 10]") == 10);
+    REQUIRE(count("1, \"2], [\"]") == 2);
+    REQUIRE(count("\"a\\\", \\\\\", {\"b\": [1, 2], \"c\": \"]}\"}, \"long string, with, commas, and [brackets]\"]") == 3);
+    REQUIRE(count("\"x\": 1, \"y\": {\"z\": 2}}") == 2);
+    REQUIRE(count(" \n]") == 0);
+    REQUIRE(count("}") == 0);
+    REQUIRE(count("1, 2") == 0);
+    REQUIRE(count("[1, 2]") == 0);
+
+    // Commas in comments aren't items, so lists with comments aren't counted
+    REQUIRE(count("1, // a, b, c\n 2]") == 0);
+    REQUIRE(count("1, 2, 3, 4, 5, 6, 7, 8, 9, 10, // a, b, c\n 11]") == 0);
+    REQUIRE(count("\"http://x, y\", 2]") == 2);
+}
+
+TEST_CASE("Containers are reserved for contiguous input", "[parser]")
+{
+    jsoncpp::ParserOptions options;
+    options.reserveContainers = true;
+    std::vector<std::vector<int>> vectors;
+    jsoncpp::parse(vectors, std::string{"[[1, 2, 3], [], [4]]"}, options);
+    REQUIRE(vectors.capacity() == 3);
+    REQUIRE(vectors[0].capacity() == 3);
+    REQUIRE(vectors[1].capacity() == 0);
+
+    std::unordered_map<std::string, int> map;
+    jsoncpp::parse(map, std::string{"{\"a\": 1, \"b\": 2, \"c\": 3, \"d\": 4, \"e\": 5, \"f\": 6}"}, options);
+    REQUIRE(map.size() == 6);
+    REQUIRE(map.at("f") == 6);
+
+    // The hint doesn't change the result of malformed input
+    REQUIRE_THROWS_AS(jsoncpp::parse(vectors, std::string{"[[1, 2, 3]"}, options), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(vectors, std::string{"[[1, 2, 3], 4]"}, options), const jsoncpp::ParserError&);
+
+    // Comments are parsed as usual, only the hint is missing
+    std::vector<int> ints;
+    jsoncpp::parse(ints, std::string{"[1, // 2, 3\n 4]"}, options);
+    REQUIRE(ints == (std::vector<int>{1, 4}));
+
+    // It's off by default
+    REQUIRE_FALSE(jsoncpp::ParserOptions{}.reserveContainers);
+
+    options.reserveContainers = false;
+    std::deque<std::string> strings;
+    jsoncpp::parse(strings, std::string{"[\"a\", \"b, c\"]"}, options);
+    REQUIRE(strings.size() == 2);
+    REQUIRE(strings[1] == "b, c");
+}
+
+TEST_CASE("Parsing sets and maps", "[parser]")
+{
+    std::set<std::string> set;
+    jsoncpp::parse(set, R"(["a", "c", "b", "c"])");
+    REQUIRE(set == (std::set<std::string>{"a", "b", "c"}));
+
+    // Sorted keys are appended, the rest is inserted as usual
+    std::map<std::string, int> map;
+    jsoncpp::parse(map, R"({"a": 1, "b": 2, "d": 4, "c": 3, "b": 5})");
+    REQUIRE(map == (std::map<std::string, int>{{"a", 1}, {"b", 5}, {"c", 3}, {"d", 4}}));
+
+    std::map<std::int64_t, std::string> byId;
+    jsoncpp::parse(byId, R"({"-9223372036854775808": "min", "-1": "a", "0": "b", "9223372036854775807": "max"})");
+    REQUIRE(byId.size() == 4);
+    REQUIRE(byId.at(std::numeric_limits<std::int64_t>::min()) == "min");
+    REQUIRE(byId.at(-1) == "a");
+    REQUIRE(byId.at(0) == "b");
+    REQUIRE(byId.at(std::numeric_limits<std::int64_t>::max()) == "max");
+
+    std::unordered_map<std::uint16_t, int> counts;
+    jsoncpp::parse(counts, R"({"65535": 1, "007": 2, "-0": 3})");
+    REQUIRE(counts.size() == 3);
+    REQUIRE(counts.at(65535) == 1);
+    REQUIRE(counts.at(7) == 2);
+    REQUIRE(counts.at(0) == 3);
+
+    REQUIRE_THROWS_AS(jsoncpp::parse(counts, R"({"65536": 1})"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(counts, R"({"-1": 1})"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(counts, R"({"": 1})"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(counts, R"({"1a": 1})"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(byId, R"({"-": "x"})"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(byId, R"({"9223372036854775808": "x"})"), const jsoncpp::ParserError&);
+
+    try
+    {
+        jsoncpp::parse(counts, R"({"1": 1, "x": 2})");
+        FAIL("parse() must throw");
+    }
+    catch (const jsoncpp::ParserError& e)
+    {
+        REQUIRE(e.type() == jsoncpp::ParserError::UnexpectedCharacter);
+    }
+}
+
+TEST_CASE("Parsing fixed-size arrays and tuples", "[parser]")
+{
+    std::array<double, 3> point;
+    jsoncpp::parse(point, "[1, 2.5, -3]");
+    REQUIRE(point == (std::array<double, 3>{{1, 2.5, -3}}));
+
+    int ids[2][2];
+    jsoncpp::parse(ids, "[[1, 2], [3, 4]]");
+    REQUIRE(ids[0][1] == 2);
+    REQUIRE(ids[1][0] == 3);
+
+    std::tuple<int, std::string, bool> row;
+    jsoncpp::parse(row, R"([7, "seven", true])");
+    REQUIRE(row == std::make_tuple(7, std::string{"seven"}, true));
+
+    std::pair<std::string, double> pair;
+    jsoncpp::parse(pair, R"(["x", 0.5])");
+    REQUIRE(pair == std::make_pair(std::string{"x"}, 0.5));
+
+    REQUIRE_THROWS_AS(jsoncpp::parse(point, "[1, 2]"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(point, "[1, 2, 3, 4]"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(row, R"([7, "seven"])"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(pair, R"(["x", 0.5, 1])"), const jsoncpp::ParserError&);
+
+    try
+    {
+        jsoncpp::parse(ids, "[[1, 2], [3]]");
+        FAIL("parse() must throw");
+    }
+    catch (const jsoncpp::ParserError& e)
+    {
+        REQUIRE(e.type() == jsoncpp::ParserError::WrongArraySize);
+    }
+}
+
+TEST_CASE("Parsing fixed-capacity strings", "[parser]")
+{
+    jsoncpp::FixedString<8> str;
+    jsoncpp::parse(str, R"("ab\u00e9\n")");
+    REQUIRE(str == "ab\xC3\xA9\n");
+    REQUIRE(str.size() == 5);
+
+    jsoncpp::parse(str, R"("12345678")");
+    REQUIRE(str == "12345678");
+
+    char name[4];
+    jsoncpp::parse(name, R"("abc")");
+    REQUIRE(std::string{name} == "abc");
+
+    try
+    {
+        jsoncpp::parse(str, R"("123456789")");
+        FAIL("parse() must throw");
+    }
+    catch (const jsoncpp::ParserError& e)
+    {
+        REQUIRE(e.type() == jsoncpp::ParserError::StringIsTooLong);
+    }
+
+    REQUIRE_THROWS_AS(jsoncpp::parse(name, R"("abcd")"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(str, "1"), const jsoncpp::ParserError&);
+}
+
+TEST_CASE("Parsing interned strings", "[parser]")
+{
+    std::vector<jsoncpp::InternedString> statuses;
+    jsoncpp::parse(statuses, R"(["ok", "failed", "ok", "ok", "a status which doesn't fit in a small buffer", "failed"])");
+    REQUIRE(statuses.size() == 6);
+    REQUIRE(statuses[0] == "ok");
+    REQUIRE(statuses[4].str() == "a status which doesn't fit in a small buffer");
+
+    // Equal strings share the characters
+    REQUIRE(statuses[0].data() == statuses[3].data());
+    REQUIRE(statuses[1].data() == statuses[5].data());
+    REQUIRE(statuses[0].data() == jsoncpp::InternedString{"ok"}.data());
+    REQUIRE(statuses[0] != statuses[1]);
+
+    // Other pools have their own copies
+    jsoncpp::StringPool pool;
+    jsoncpp::InternedString local{"ok", pool};
+    REQUIRE(local == statuses[0]);
+    REQUIRE(local.data() != statuses[0].data());
+    REQUIRE(pool.size() == 1);
+    REQUIRE(jsoncpp::InternedString{}.size() == 0);
+
+    // Threads which intern the same strings get the same copies
+    std::vector<std::vector<jsoncpp::InternedString>> results(4);
+    std::vector<std::thread> threads;
+    for (auto& result : results)
+    {
+        threads.emplace_back([&pool, &result]
+        {
+            for (auto i = 0; i != 1000; ++i)
+                result.push_back(jsoncpp::InternedString{"code " + std::to_string(i % 100), pool});
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(pool.size() == 101);
+    for (auto& result : results)
+        REQUIRE(result[42].data() == results[0][42].data());
+}
+
+TEST_CASE("Parsing to float", "[parser]")
+{
+    std::vector<float> arr;
+    jsoncpp::parse(arr, "[0.1, -2.5e-3, 3.4028235e38, 1e-45, 16777217, 0]");
+    REQUIRE(arr.size() == 6);
+    REQUIRE(arr[0] == 0.1f);
+    REQUIRE(arr[1] == -2.5e-3f);
+    REQUIRE(arr[2] == FLT_MAX);
+    REQUIRE(arr[3] == std::numeric_limits<float>::denorm_min());
+    REQUIRE(arr[4] == 16777216.0f);
+    REQUIRE(arr[5] == 0);
+
+    // Above the midpoint of 1 and the next float, but rounding to double first would give the midpoint
+    jsoncpp::parse(arr, "[1.0000000596046448]");
+    REQUIRE(arr[0] == std::nextafter(1.0f, 2.0f));
+
+    REQUIRE_THROWS_AS(jsoncpp::parse(arr, "[3.5e38]"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(arr, "[1.]"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(arr, "[1e]"), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::parse(arr, "[-]"), const jsoncpp::ParserError&);
+}
+
 namespace
 {
     struct Point
@@ -296,3 +815,46 @@ TEST_CASE("Parsing to a user-defined type")
     REQUIRE(foo.arr[0] == 1);
     REQUIRE(foo.arr[1] == 2);
 }
+
+TEST_CASE("Parsing in place", "[parser]")
+{
+    jsoncpp::ParserOptions options;
+    options.updateInPlace = true;
+
+    std::vector<std::string> strings{"a long string which doesn't fit in a small buffer", "b", "c"};
+    auto data = strings[0].data();
+    jsoncpp::parse(strings, std::string{R"(["x", "y"])"}, options);
+    REQUIRE(strings == (std::vector<std::string>{"x", "y"}));
+    REQUIRE(strings[0].data() == data);
+
+    jsoncpp::parse(strings, R"(["x", "y", "z"])", options);
+    REQUIRE(strings == (std::vector<std::string>{"x", "y", "z"}));
+
+    std::list<Point> points{{1, 2}, {3, 4}};
+    jsoncpp::parse(points, R"([{"x": 5}])", options);
+    REQUIRE(points.size() == 1);
+    REQUIRE(points.front().x == 5);
+    REQUIRE(points.front().y == 2);
+
+    // Maps are merged
+    std::map<std::string, int> map{{"a", 1}, {"b", 2}};
+    jsoncpp::parse(map, R"({"b": 3, "c": 4})", options);
+    REQUIRE(map == (std::map<std::string, int>{{"a", 1}, {"b", 3}, {"c", 4}}));
+
+    std::unique_ptr<Point> ptr{new Point{1, 2}};
+    auto pointee = ptr.get();
+    jsoncpp::parse(ptr, R"({"y": 3})", options);
+    REQUIRE(ptr.get() == pointee);
+    REQUIRE(ptr->x == 1);
+    REQUIRE(ptr->y == 3);
+
+    jsoncpp::parse(ptr, R"({"y": 4})");
+    REQUIRE(ptr->y == 4);
+
+    jsoncpp::parse(ptr, "null", options);
+    REQUIRE(ptr == nullptr);
+
+    // Without the option the containers are cleared
+    jsoncpp::parse(map, R"({"c": 5})");
+    REQUIRE(map.size() == 1);
+}
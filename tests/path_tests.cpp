@@ -0,0 +1,126 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/path.hpp>
+#include <json-cpp/std_types.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* const eventsText = R"(
+        {
+            "header": {"user": {"id": -1}},
+            "events": [
+                {"user": {"id": 1, "name": "a"}, "payload": [1, 2, {"user": {"id": -2}}]},
+                {"type": "empty"},
+                {"user": {"name": "c", "id": 3}},
+                {"user": "not an object"}
+            ]
+        }
+    )";
+
+    struct User
+    {
+        int id;
+        std::string name;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, User& o)
+    {
+        fields(o, stream, "id", o.id, "name", o.name);
+    }
+}
+
+TEST_CASE("Compiling a path", "[path]")
+{
+    jsoncpp::Path path{"/a~1b/*/12/m~0n"};
+    REQUIRE(path.size() == 4);
+    CHECK(path[0].name == "a/b");
+    CHECK(path[1].isWildcard);
+    CHECK(path[2].isIndex);
+    CHECK(path[2].index == 12);
+    CHECK(path[3].name == "m~n");
+    CHECK_FALSE(path[3].isIndex);
+
+    // Array indices have no leading zeros
+    path = jsoncpp::Path{"/0/01/00/99999999999999999999999"};
+    CHECK(path[0].isIndex);
+    CHECK(path[0].index == 0);
+    CHECK_FALSE(path[1].isIndex);
+    CHECK(path[1].name == "01");
+    CHECK_FALSE(path[2].isIndex);
+    CHECK_FALSE(path[3].isIndex);
+
+    REQUIRE(jsoncpp::Path{""}.size() == 0);
+    REQUIRE_THROWS_AS(jsoncpp::Path{"a"}, const std::invalid_argument&);
+    REQUIRE_THROWS_AS(jsoncpp::Path{"/a~2"}, const std::invalid_argument&);
+}
+
+TEST_CASE("Extracting values by a path with wildcards", "[path]")
+{
+    std::vector<int> ids;
+    jsoncpp::extract<int>(eventsText, jsoncpp::Path{"/events/*/user/id"}, [&](int id)
+    {
+        ids.push_back(id);
+    });
+
+    REQUIRE(ids == (std::vector<int>{1, 3}));
+}
+
+TEST_CASE("Extracted values don't keep fields of previous matches", "[path]")
+{
+    std::vector<User> users;
+    jsoncpp::extract<User>(R"([{"id": 1, "name": "a"}, {"id": 2}])", jsoncpp::Path{"/*"}, [&](const User& user)
+    {
+        users.push_back(user);
+    });
+
+    REQUIRE(users.size() == 2);
+    CHECK(users[1].id == 2);
+    CHECK(users[1].name.empty());
+}
+
+TEST_CASE("Extracting values by a path with array indices", "[path]")
+{
+    std::stringstream stream{eventsText};
+    std::vector<std::string> names;
+    jsoncpp::extract<std::string>(stream, jsoncpp::Path{"/events/2/user/name"}, [&](const std::string& name)
+    {
+        names.push_back(name);
+    });
+
+    REQUIRE(names == (std::vector<std::string>{"c"}));
+
+    // A token with a leading zero isn't an index, but it's still a field name
+    std::vector<int> values;
+    auto collect = [&](int value) { values.push_back(value); };
+    jsoncpp::extract<int>(R"({"items": [10, 11, 12]})", jsoncpp::Path{"/items/01"}, collect);
+    REQUIRE(values.empty());
+
+    jsoncpp::extract<int>(R"({"items": {"1": 1, "01": 2}})", jsoncpp::Path{"/items/01"}, collect);
+    REQUIRE(values == (std::vector<int>{2}));
+}
+
+TEST_CASE("Matching a path with a raw parser callback", "[path]")
+{
+    std::string text{eventsText};
+    using Iterator = std::string::const_iterator;
+    jsoncpp::Parser<jsoncpp::details::Traits2<char, Iterator>> parser{text.begin(), text.end()};
+
+    std::vector<jsoncpp::Type> types;
+    jsoncpp::matchPath(parser, jsoncpp::Path{"/events/*/user"}, [&](decltype(parser)& p)
+    {
+        types.push_back(p.getType());
+        p.skipValue();
+    });
+
+    std::vector<jsoncpp::Type> expected{jsoncpp::Type::Object, jsoncpp::Type::Object, jsoncpp::Type::String};
+    REQUIRE(types == expected);
+}
@@ -0,0 +1,72 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/projection.hpp>
+#include <json-cpp/std_types.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Inner
+    {
+        int x{0};
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Inner& o)
+    {
+        fields(o, stream, "x", o.x);
+    }
+
+    struct Record
+    {
+        Inner inner;
+        int a{0};
+        std::string b;
+        std::vector<int> c;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Record& o)
+    {
+        fields(o, stream, "inner", o.inner, "a", o.a, "b", o.b, "c", o.c);
+    }
+}
+
+TEST_CASE("Parsing only selected fields", "[projection]")
+{
+    Record rec;
+    jsoncpp::parse_only(rec, R"({"inner": {"x": 1}, "a": 2, "b": "3", "c": [4, {"ignored": 5}]})",
+        &Record::inner, &Record::b);
+
+    REQUIRE(rec.inner.x == 1);
+    REQUIRE(rec.a == 0);
+    REQUIRE(rec.b == "3");
+    REQUIRE(rec.c.empty());
+}
+
+TEST_CASE("Projection still reports unknown fields", "[projection]")
+{
+    Record rec;
+    REQUIRE_THROWS_AS(jsoncpp::parse_only(rec, R"({"a": 1, "d": 2})", &Record::a),
+        const jsoncpp::ParserError&);
+}
+
+TEST_CASE("Projection stops when all fields are filled", "[projection]")
+{
+    auto&& truncated = R"({"a": 1, "c": [1, 2], "b": "x", "c": [3, )";
+
+    Record rec;
+    REQUIRE_THROWS_AS(jsoncpp::parse_only(rec, truncated, &Record::a, &Record::b),
+        const jsoncpp::ParserError&);
+
+    auto projection = jsoncpp::project(rec, &Record::a, &Record::b).stopWhenFilled();
+    jsoncpp::parse(projection, truncated);
+    REQUIRE(rec.a == 1);
+    REQUIRE(rec.b == "x");
+    REQUIRE(rec.c.empty());
+}
@@ -0,0 +1,284 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/snapshot.hpp>
+#include <json-cpp/serialization_helpers.hpp>
+#include <json-cpp/std_types.hpp>
+
+#if !defined _WIN32
+#   include <json-cpp/snapshot_file.hpp>
+#   include <cstdio>
+#   include <cstdlib>
+#endif
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Station
+    {
+        int id;
+        double lat;
+        unsigned long long code;
+        bool active;
+        std::string name;
+        std::wstring alias;
+        std::shared_ptr<int> parent;
+        std::vector<int> lines;
+        std::map<std::string, std::string> tags;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Station& o)
+    {
+        fields(o, stream, "id", o.id, "lat", o.lat, "code", o.code, "active", o.active, "name", o.name,
+            "alias", o.alias, "parent", o.parent, "lines", o.lines, "tags", o.tags);
+    }
+
+    std::vector<Station> makeStations()
+    {
+        return{
+            {1, 51.5, 18446744073709551615ull, true, "Bank", L"B\u00E4nk", nullptr, {1, 2, 3}, {{"zone", "1"}, {"a", "b"}}},
+            {-2, -0.25, 7, false, "Angel", L"", std::make_shared<int>(1), {}, {}},
+        };
+    }
+}
+
+TEST_CASE("Reading a snapshot view", "[snapshot]")
+{
+    auto data = jsoncpp::to_snapshot(makeStations());
+
+    jsoncpp::SnapshotView view{data.data(), data.size()};
+    auto root = view.root();
+    REQUIRE(root.getType() == jsoncpp::Type::Array);
+    REQUIRE(root.size() == 2);
+
+    auto bank = root[0];
+    CHECK(bank.getType() == jsoncpp::Type::Object);
+    CHECK(bank.size() == 9);
+    CHECK(bank["id"].isInteger());
+    CHECK(bank["id"].getInteger() == 1);
+    CHECK(bank["lat"].getNumber() == 51.5);
+    CHECK_FALSE(bank["lat"].isInteger());
+    CHECK(bank["code"].getNumber() == 18446744073709551615.0);
+    CHECK(bank["active"].getBoolean() == true);
+    CHECK(bank["name"].getString().str() == "Bank");
+    CHECK(std::string{bank["name"].c_str()} == "Bank");
+    CHECK(bank["alias"].getString().str() == "B\xC3\xA4nk");
+    CHECK(bank["parent"].getType() == jsoncpp::Type::Null);
+    CHECK(bank["lines"].size() == 3);
+    CHECK(bank["lines"][2].getInteger() == 3);
+    CHECK(bank["tags"]["zone"].getString().str() == "1");
+
+    // Fields are sorted by name
+    CHECK(bank.fieldName(0).str() == "active");
+    CHECK(bank.fieldName(8).str() == "tags");
+    CHECK(bank.fieldValue(8).fieldName(0).str() == "a");
+
+    auto angel = root[1];
+    CHECK(angel["id"].getNumber() == -2);
+    CHECK(angel["parent"].getInteger() == 1);
+    CHECK(angel["lines"].size() == 0);
+
+    jsoncpp::SnapshotValue value;
+    CHECK_FALSE(angel.findField("missing", value));
+    REQUIRE_THROWS_AS(angel["missing"], const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(angel["name"].getNumber(), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(root[2], const std::out_of_range&);
+}
+
+TEST_CASE("Field names are written once", "[snapshot]")
+{
+    std::vector<Station> one(1), many(100);
+    auto perStation = (jsoncpp::to_snapshot(many).size() - jsoncpp::to_snapshot(one).size()) / 99;
+    CHECK(perStation < 400);
+}
+
+TEST_CASE("Integer map keys in a snapshot", "[snapshot]")
+{
+    std::map<int, int> map{{1, 10}, {2, 20}, {-3, 30}};
+    auto data = jsoncpp::to_snapshot(map);
+
+    auto root = jsoncpp::SnapshotView(data.data(), data.size()).root();
+    REQUIRE(root.size() == 3);
+    CHECK(root.fieldName(0).str() == "-3");
+    CHECK(root.fieldName(1).str() == "1");
+    CHECK(root.fieldName(2).str() == "2");
+    CHECK(root["1"].getInteger() == 10);
+    CHECK(root["2"].getInteger() == 20);
+    CHECK(root["-3"].getInteger() == 30);
+}
+
+TEST_CASE("64-bit integers in a snapshot", "[snapshot]")
+{
+    std::vector<unsigned long long> unsignedValues{18446744073709551615ull, 9223372036854775808ull, 5};
+    auto data = jsoncpp::to_snapshot(unsignedValues);
+    auto root = jsoncpp::SnapshotView(data.data(), data.size()).root();
+    CHECK(root[0].isInteger());
+    CHECK(root[0].getUnsigned() == 18446744073709551615ull);
+    CHECK(root[1].getUnsigned() == 9223372036854775808ull);
+    CHECK(root[2].getUnsigned() == 5);
+    CHECK(root[2].getInteger() == 5);
+    CHECK(root[0].getNumber() == 18446744073709551615.0);
+    REQUIRE_THROWS_AS(root[0].getInteger(), const jsoncpp::ParserError&);
+
+    std::vector<long long> signedValues{INT64_MIN, INT64_MAX, -1};
+    data = jsoncpp::to_snapshot(signedValues);
+    root = jsoncpp::SnapshotView(data.data(), data.size()).root();
+    CHECK(root[0].getInteger() == INT64_MIN);
+    CHECK(root[1].getInteger() == INT64_MAX);
+    REQUIRE_THROWS_AS(root[2].getUnsigned(), const jsoncpp::ParserError&);
+
+    // Doubles out of the range of the type aren't converted
+    std::vector<double> doubles{1e30, -1e30, std::nan(""), -7.5, 9223372036854775808.0};
+    data = jsoncpp::to_snapshot(doubles);
+    root = jsoncpp::SnapshotView(data.data(), data.size()).root();
+    REQUIRE_THROWS_AS(root[0].getInteger(), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(root[1].getInteger(), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(root[2].getInteger(), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(root[2].getUnsigned(), const jsoncpp::ParserError&);
+    CHECK(root[3].getInteger() == -7);
+    REQUIRE_THROWS_AS(root[3].getUnsigned(), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(root[4].getInteger(), const jsoncpp::ParserError&);
+    CHECK(root[4].getUnsigned() == 9223372036854775808ull);
+}
+
+TEST_CASE("Invalid snapshot header", "[snapshot]")
+{
+    auto data = jsoncpp::to_snapshot(42);
+    CHECK(jsoncpp::SnapshotView(data.data(), data.size()).root().getInteger() == 42);
+
+    REQUIRE_THROWS_AS(jsoncpp::SnapshotView(data.data(), 16), const jsoncpp::ParserError&);
+    REQUIRE_THROWS_AS(jsoncpp::SnapshotView(data.data(), data.size() - 8), const jsoncpp::ParserError&);
+
+    // Version 1 has no unsigned nodes, otherwise it's the same
+    data[4] = 1;
+    CHECK(jsoncpp::SnapshotView(data.data(), data.size()).root().getInteger() == 42);
+    data[4] = 3;
+    REQUIRE_THROWS_AS(jsoncpp::SnapshotView(data.data(), data.size()), const jsoncpp::ParserError&);
+
+    data[0] = '{';
+    REQUIRE_THROWS_AS(jsoncpp::SnapshotView(data.data(), data.size()), const jsoncpp::ParserError&);
+}
+
+namespace
+{
+    std::uint64_t rootOffset(const std::string& data)
+    {
+        std::uint64_t offset;
+        std::memcpy(&offset, data.data() + 8, sizeof(offset));
+        return offset;
+    }
+
+    void storeAt(std::string& data, std::uint64_t offset, std::uint64_t value, std::size_t size)
+    {
+        std::memcpy(&data[offset], &value, size);
+    }
+}
+
+TEST_CASE("Corrupt snapshot nodes", "[snapshot]")
+{
+    auto array = jsoncpp::to_snapshot(std::vector<int>{1, 2, 3});
+    auto root = rootOffset(array);
+
+    SECTION("element offset past the end")
+    {
+        storeAt(array, root + 8, uint64_t{1} << 40, 8);
+        auto value = jsoncpp::SnapshotView(array.data(), array.size()).root();
+        REQUIRE_THROWS_AS(value[0], const jsoncpp::ParserError&);
+        CHECK(value[1].getInteger() == 2);
+    }
+
+    SECTION("element offset in the header")
+    {
+        storeAt(array, root + 8, 8, 8);
+        REQUIRE_THROWS_AS(jsoncpp::SnapshotView(array.data(), array.size()).root()[0], const jsoncpp::ParserError&);
+    }
+
+    SECTION("too many elements")
+    {
+        storeAt(array, root + 4, 1000, 4);
+        REQUIRE_THROWS_AS(jsoncpp::SnapshotView(array.data(), array.size()), const jsoncpp::ParserError&);
+    }
+
+    SECTION("truncated snapshot")
+    {
+        // The header claims a smaller snapshot, so its last node is cut off
+        storeAt(array, 16, array.size() - 8, 8);
+        REQUIRE_THROWS_AS(jsoncpp::SnapshotView(array.data(), array.size()), const jsoncpp::ParserError&);
+    }
+
+    auto str = jsoncpp::to_snapshot(std::string{"abc"});
+    root = rootOffset(str);
+    CHECK(jsoncpp::SnapshotView(str.data(), str.size()).root().getString().str() == "abc");
+
+    SECTION("string too long")
+    {
+        storeAt(str, root + 4, 1000, 4);
+        REQUIRE_THROWS_AS(jsoncpp::SnapshotView(str.data(), str.size()), const jsoncpp::ParserError&);
+    }
+
+    SECTION("string without the terminating zero")
+    {
+        str[root + 8 + 3] = 'd';
+        REQUIRE_THROWS_AS(jsoncpp::SnapshotView(str.data(), str.size()), const jsoncpp::ParserError&);
+    }
+}
+
+TEST_CASE("A reused name buffer gets its own field names", "[snapshot]")
+{
+    std::string data;
+    jsoncpp::Generator<jsoncpp::details::SnapshotTraits<std::string>> stream{data};
+
+    char name[8];
+    int values[] = {1, 2, 3};
+    const char* names[] = {"first", "second", "first"};
+    stream.objectBegin();
+    for (auto i = 0; i != 3; ++i)
+    {
+        std::strcpy(name, names[i]);
+        stream.fieldName(static_cast<const char*>(name));
+        serialize(stream, values[i]);
+    }
+    stream.objectEnd();
+
+    auto root = jsoncpp::SnapshotView(data.data(), data.size()).root();
+    REQUIRE(root.size() == 3);
+    CHECK(root.fieldName(0).str() == "first");
+    CHECK(root.fieldName(1).str() == "first");
+    CHECK(root.fieldName(2).str() == "second");
+    CHECK(root["second"].getInteger() == 2);
+
+    // The name is written once for each content
+    CHECK(data.find("first") == data.rfind("first"));
+}
+
+#if !defined _WIN32
+TEST_CASE("Memory-mapped snapshot file", "[snapshot]")
+{
+    char path[] = "/tmp/jsoncpp_snapshot_XXXXXX";
+    auto fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+
+    auto data = jsoncpp::to_snapshot(makeStations());
+    REQUIRE(::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+    ::close(fd);
+
+    {
+        jsoncpp::MappedSnapshot snapshot{path};
+        CHECK(snapshot.root()[1]["name"].getString().str() == "Angel");
+    }
+
+    std::remove(path);
+    REQUIRE_THROWS_AS(jsoncpp::MappedSnapshot{path}, const std::system_error&);
+}
+#endif
@@ -0,0 +1,125 @@
+// JSON for C++ : tests
+// Belongs to the public domain
+
+#include "catch_wrap.hpp"
+
+#include <json-cpp/stats.hpp>
+#include <json-cpp/projection.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Inner
+    {
+        std::vector<int> arr;
+        bool flag;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Inner& o)
+    {
+        fields(o, stream, "arr", o.arr, "flag", o.flag);
+    }
+
+    struct Outer
+    {
+        std::string name;
+        double num;
+        Inner inner;
+        std::shared_ptr<int> ptr;
+    };
+
+    template<class X>
+    inline void serialize(jsoncpp::Stream<X>& stream, Outer& o)
+    {
+        fields(o, stream, "name", o.name, "num", o.num, "inner", o.inner, "ptr", o.ptr);
+    }
+
+    const char* const Text = R"({"name": "a\"b\n", "num": 1.5, "inner": {"arr": [1, [2]], "flag": true}, "ptr": null})";
+}
+
+TEST_CASE("Parser statistics", "[stats]")
+{
+    Outer outer;
+    jsoncpp::Stats stats;
+    REQUIRE_THROWS_AS(jsoncpp::parse(outer, Text, stats), const jsoncpp::ParserError&);
+
+    stats = jsoncpp::Stats{};
+    std::string text = R"({"name": "a\"b\n", "num": 1.5, "inner": {"arr": [1, 2], "flag": true}, "ptr": null})";
+    jsoncpp::parse(outer, text, stats);
+
+    CHECK(outer.name == "a\"b\n");
+    CHECK(stats.bytes == text.size());
+    CHECK(stats.objects == 2);
+    CHECK(stats.arrays == 1);
+    CHECK(stats.numbers == 3);
+    CHECK(stats.strings == 1);
+    CHECK(stats.booleans == 1);
+    CHECK(stats.nulls == 1);
+    CHECK(stats.stringCount == 7);
+    CHECK(stats.stringLength == 4 + 4 + 3 + 5 + 3 + 4 + 3);
+    CHECK(stats.escapes == 2);
+    CHECK(stats.maxDepth == 3);
+    CHECK(stats.seconds > 0);
+
+    REQUIRE(stats.types.size() == 2);
+    CHECK(stats.types.begin()->first.find("Inner") != std::string::npos);
+    CHECK(stats.fields.size() == 6);
+    for (auto& field : stats.fields)
+        CHECK(field.second.count == 1);
+}
+
+TEST_CASE("Parser statistics on other inputs", "[stats]")
+{
+    jsoncpp::Stats stats;
+    std::vector<int> arr;
+
+    jsoncpp::parse(arr, "[1, 2]", stats);
+    std::istringstream stream{"[3]"};
+    jsoncpp::parse(arr, stream, stats);
+
+    CHECK(stats.bytes == 9);
+    CHECK(stats.numbers == 3);
+    CHECK(stats.arrays == 2);
+    CHECK(stats.maxDepth == 1);
+}
+
+TEST_CASE("Skipped values are counted", "[stats]")
+{
+    Outer outer;
+    jsoncpp::Stats stats;
+    std::string text = R"({"name": "x", "num": 2, "inner": {"arr": [], "flag": false}, "ptr": 1})";
+    auto projection = jsoncpp::project(outer, &Outer::num);
+    jsoncpp::parse(projection, text, stats);
+
+    CHECK(outer.num == 2);
+    CHECK(stats.skippedValues == 3);
+}
+
+TEST_CASE("Generator statistics", "[stats]")
+{
+    Outer outer{"a\"b\n", 1.5, {{1, 2}, true}, nullptr};
+    jsoncpp::Stats stats;
+    auto text = jsoncpp::to_string(outer, stats);
+
+    CHECK(text == jsoncpp::to_string(outer));
+    CHECK(stats.bytes == text.size());
+    CHECK(stats.objects == 2);
+    CHECK(stats.arrays == 1);
+    CHECK(stats.numbers == 3);
+    CHECK(stats.strings == 1);
+    CHECK(stats.nulls == 1);
+    CHECK(stats.stringCount == 7);
+    CHECK(stats.escapes == 2);
+    CHECK(stats.maxDepth == 3);
+    CHECK(stats.fields.size() == 6);
+
+    // Stats can be exported with the library itself
+    jsoncpp::Stats copy;
+    jsoncpp::parse(copy, jsoncpp::to_string(stats));
+    CHECK(copy.fields.size() == 6);
+    CHECK(copy.escapes == 2);
+}